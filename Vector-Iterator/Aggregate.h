@@ -0,0 +1,335 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "SimpelVector.h"
+#include "Parallel.h"
+#include "Platform.h"
+
+// Counting and summing per key: histogram() and group_by_sum().
+// The AVX-512 CD conflict-free update path is opt-in through
+// SIMPEL_USE_CONFLICT_DETECTION because its scatters were slower than the
+// scalar loops where it was measured.
+// Which strategy is used depends on the number of buckets:
+//  - small (<= kSmallBuckets): every thread counts into private tables, kept
+//    as kSubHistograms interleaved copies so that runs of equal keys update
+//    different counters instead of stalling on one store-to-load chain;
+//  - up to kCacheBuckets: one private table per thread, merged at the end;
+//  - beyond that a private table no longer fits in cache, so the pairs are
+//    first radix-partitioned by their high key bits and every partition then
+//    counts into its own cache-sized slice of the result, with no merge.
+// group_by_sum() without a bucket count takes arbitrary integer keys and
+// partitions them by hash instead, each partition aggregating in a small
+// open-addressing table.
+
+namespace aggregate_detail {
+
+constexpr size_t kSubHistograms = 4;
+constexpr size_t kSmallBuckets = 256;
+constexpr size_t kCacheBuckets = size_t(1) << 16;
+constexpr unsigned kCacheBucketBits = 16;
+
+// key as a bucket index; throws std::out_of_range outside [0, buckets)
+template <typename Key>
+size_t bucket_of(const Key& key, size_t buckets) {
+    static_assert(std::is_integral_v<Key>, "keys must be integers");
+    if constexpr (std::is_signed_v<Key>) {
+        if (key < 0) {
+            throw std::out_of_range("Key outside the histogram's buckets");
+        }
+    }
+    if (static_cast<uint64_t>(key) >= buckets) {
+        throw std::out_of_range("Key outside the histogram's buckets");
+    }
+    return static_cast<size_t>(key);
+}
+
+template <typename Key>
+uint64_t hash_of(const Key& key) {
+    uint64_t h = static_cast<uint64_t>(key);
+    h ^= h >> 32;
+    return h * 0x9E3779B97F4A7C15ull;
+}
+
+#if defined(SIMPEL_HAS_AVX512CD) && defined(SIMPEL_USE_CONFLICT_DETECTION)
+// Conflict-free vector updates of table[key] += value, 8 pairs per step;
+// returns where the scalar loop has to continue.
+template <bool Counting, typename Key, typename Sum>
+size_t accumulate_conflict_free(const Key* keys, const Sum* values, size_t begin, size_t end, Sum* table, size_t buckets) {
+    const __m512i limit = _mm512_set1_epi64(static_cast<long long>(buckets));
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m512i index;
+        if constexpr (sizeof(Key) == 8) {
+            index = _mm512_loadu_si512(keys + i);
+        } else if constexpr (std::is_signed_v<Key>) {
+            index = _mm512_cvtepi32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)));
+        } else {
+            index = _mm512_cvtepu32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)));
+        }
+        // negative keys are huge as unsigned, so one compare covers both bounds
+        if (_mm512_cmpge_epu64_mask(index, limit)) {
+            throw std::out_of_range("Key outside the histogram's buckets");
+        }
+        const __m512i lane_values = Counting ? _mm512_set1_epi64(1) : _mm512_loadu_si512(values + i);
+
+        // bit j of lane k: lane j < k has the same key. Every lane adds the
+        // values of its earlier duplicates, so the last lane of each key holds
+        // the key's total and is the only one that stores.
+        const __m512i conflicts = _mm512_conflict_epi64(index);
+        unsigned earlier = static_cast<unsigned>(_mm512_reduce_or_epi64(conflicts)) & 0xFF;
+        const __mmask8 last = static_cast<__mmask8>(~earlier);
+        __m512i sum = lane_values;
+        while (earlier) {
+            const int j = std::countr_zero(earlier);
+            earlier &= earlier - 1;
+            const __mmask8 takers = _mm512_test_epi64_mask(conflicts, _mm512_set1_epi64(1ll << j));
+            sum = _mm512_mask_add_epi64(sum, takers, sum, _mm512_permutexvar_epi64(_mm512_set1_epi64(j), lane_values));
+        }
+        const __m512i counters = _mm512_i64gather_epi64(index, table, 8);
+        _mm512_mask_i64scatter_epi64(table, last, index, _mm512_add_epi64(counters, sum), 8);
+    }
+    return i;
+}
+#endif
+
+// table[copy * buckets + key] += value for the pairs in [begin, end); element i
+// goes to copy i % copies (copies is 1 or kSubHistograms). Counting: value 1.
+template <bool Counting, typename Key, typename Sum>
+void accumulate(const Key* keys, const Sum* values, size_t begin, size_t end, Sum* table, size_t buckets, size_t copies) {
+    const auto value = [&](size_t i) { return Counting ? Sum(1) : values[i]; };
+    size_t i = begin;
+#if defined(SIMPEL_HAS_AVX512CD) && defined(SIMPEL_USE_CONFLICT_DETECTION)
+    if constexpr (std::is_integral_v<Sum> && sizeof(Sum) == 8 && (sizeof(Key) == 4 || sizeof(Key) == 8)) {
+        i = accumulate_conflict_free<Counting>(keys, values, begin, end, table, buckets);
+    }
+#endif
+    if (copies == kSubHistograms) {
+        Sum* table1 = table + buckets;
+        Sum* table2 = table1 + buckets;
+        Sum* table3 = table2 + buckets;
+        for (; i + 4 <= end; i += 4) {
+            table[bucket_of(keys[i], buckets)] += value(i);
+            table1[bucket_of(keys[i + 1], buckets)] += value(i + 1);
+            table2[bucket_of(keys[i + 2], buckets)] += value(i + 2);
+            table3[bucket_of(keys[i + 3], buckets)] += value(i + 3);
+        }
+    }
+    for (; i < end; ++i) {
+        table[bucket_of(keys[i], buckets)] += value(i);
+    }
+}
+
+// Scatter the pairs into parts partitions (stable within each chunk):
+// histogram per chunk, partition-major prefix sum, scatter. Returns the parts
+// + 1 partition offsets into out_keys / out_values.
+template <bool WithValues, typename Key, typename Value, typename PartOf>
+SimpelVector<size_t> partition(const Key* keys, const Value* values, size_t n, size_t parts, PartOf part_of,
+                               Key* out_keys, Value* out_values) {
+    const size_t chunks = parallel_chunk_count(n);
+    SimpelVector<size_t> cursors;
+    cursors.resize(chunks * parts);
+    parallel_chunks(n, chunks, [&](size_t chunk, size_t begin, size_t end) {
+        size_t* count = cursors.data() + chunk * parts;
+        for (size_t i = begin; i < end; ++i) {
+            ++count[part_of(keys[i])];
+        }
+    });
+    SimpelVector<size_t> offsets;
+    offsets.resize(parts + 1);
+    size_t position = 0;
+    for (size_t part = 0; part < parts; ++part) {
+        offsets.data()[part] = position;
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            size_t& cursor = cursors.data()[chunk * parts + part];
+            const size_t count = cursor;
+            cursor = position;
+            position += count;
+        }
+    }
+    offsets.data()[parts] = position;
+    parallel_chunks(n, chunks, [&](size_t chunk, size_t begin, size_t end) {
+        size_t* cursor = cursors.data() + chunk * parts;
+        for (size_t i = begin; i < end; ++i) {
+            const size_t at = cursor[part_of(keys[i])]++;
+            out_keys[at] = keys[i];
+            if constexpr (WithValues) {
+                out_values[at] = values[i];
+            }
+        }
+    });
+    return offsets;
+}
+
+// per-bucket sums (or counts) of keys in [0, buckets)
+template <bool Counting, typename Key, typename Sum>
+SimpelVector<Sum> dense_aggregate(const Key* keys, const Sum* values, size_t n, size_t buckets) {
+    SimpelVector<Sum> result;
+    result.resize(buckets);
+    Sum* out = result.data();
+    const size_t chunks = parallel_chunk_count(n);
+
+    if (buckets > kCacheBuckets && n > kParallelGrain) {
+        // partition by the high bits, then count each cache-sized slice in place
+        SimpelVector<Key> sorted_keys;
+        sorted_keys.resize(n);
+        SimpelVector<Sum> sorted_values;
+        if constexpr (!Counting) {
+            sorted_values.resize(n);
+        }
+        const size_t parts = ((buckets - 1) >> kCacheBucketBits) + 1;
+        const SimpelVector<size_t> offsets = partition<!Counting>(keys, values, n, parts,
+            [buckets](const Key& key) { return bucket_of(key, buckets) >> kCacheBucketBits; },
+            sorted_keys.data(), sorted_values.data());
+        parallel_for(parts, [&](size_t begin, size_t end) {
+            for (size_t part = begin; part < end; ++part) {
+                accumulate<Counting>(sorted_keys.data(), sorted_values.data(), offsets.data()[part],
+                                     offsets.data()[part + 1], out, buckets, 1);
+            }
+        }, 1);
+        return result;
+    }
+
+    const size_t copies = buckets <= kSmallBuckets ? kSubHistograms : 1;
+    if (chunks == 1 && copies == 1) {
+        accumulate<Counting>(keys, values, 0, n, out, buckets, 1);
+        return result;
+    }
+    const size_t tables = chunks * copies;
+    SimpelVector<Sum> private_tables;
+    private_tables.resize(tables * buckets);
+    Sum* table = private_tables.data();
+    parallel_chunks(n, chunks, [&](size_t chunk, size_t begin, size_t end) {
+        accumulate<Counting>(keys, values, begin, end, table + chunk * copies * buckets, buckets, copies);
+    });
+    parallel_for(buckets, [&](size_t begin, size_t end) {
+        for (size_t t = 0; t < tables; ++t) {
+            const Sum* partial = table + t * buckets;
+            for (size_t bucket = begin; bucket < end; ++bucket) {
+                out[bucket] += partial[bucket];
+            }
+        }
+    }, kParallelGrain / tables + 1);
+    return result;
+}
+
+} // namespace aggregate_detail
+
+// histogram: result[k] = number of keys equal to k, for integer keys in
+// [0, buckets); throws std::out_of_range for any other key.
+template <typename Key>
+SimpelVector<uint64_t> histogram(const SimpelVector<Key>& keys, size_t buckets) {
+    return aggregate_detail::dense_aggregate<true, Key, uint64_t>(keys.data(), nullptr, keys.size(), buckets);
+}
+
+// group_by_sum over dense keys: result[k] = sum of values[i] with keys[i] == k
+template <typename Key, typename Value>
+SimpelVector<Value> group_by_sum(const SimpelVector<Key>& keys, const SimpelVector<Value>& values, size_t buckets) {
+    if (keys.size() != values.size()) {
+        throw std::invalid_argument("group_by_sum needs one value per key");
+    }
+    return aggregate_detail::dense_aggregate<false>(keys.data(), values.data(), keys.size(), buckets);
+}
+
+// Distinct keys and the sum of their values, in no particular order.
+template <typename Key, typename Value>
+struct GroupSums {
+    SimpelVector<Key> keys;
+    SimpelVector<Value> sums;
+};
+
+// group_by_sum over arbitrary integer keys (high cardinality): the pairs are
+// partitioned by the top bits of a key hash, then every partition sums its
+// groups in an open-addressing table indexed by the low bits and appends them
+// to the result; partitions are independent and aggregated on the pool.
+template <typename Key, typename Value>
+GroupSums<Key, Value> group_by_sum(const SimpelVector<Key>& keys, const SimpelVector<Value>& values) {
+    static_assert(std::is_integral_v<Key>, "keys must be integers");
+    if (keys.size() != values.size()) {
+        throw std::invalid_argument("group_by_sum needs one value per key");
+    }
+    using aggregate_detail::hash_of;
+    const size_t n = keys.size();
+    GroupSums<Key, Value> result;
+    if (n == 0) {
+        return result;
+    }
+
+    // about 16K pairs per partition, so each table stays in L2
+    const unsigned bits = n > 16384 ? static_cast<unsigned>(std::bit_width((n - 1) / 16384)) : 0;
+    const unsigned part_bits = bits < 10 ? bits : 10;
+    const size_t parts = size_t(1) << part_bits;
+    SimpelVector<Key> part_keys;
+    part_keys.resize(n);
+    SimpelVector<Value> part_values;
+    part_values.resize(n);
+    const SimpelVector<size_t> offsets = aggregate_detail::partition<true>(keys.data(), values.data(), n, parts,
+        [part_bits](const Key& key) { return part_bits == 0 ? size_t(0) : static_cast<size_t>(hash_of(key) >> (64 - part_bits)); },
+        part_keys.data(), part_values.data());
+
+    // aggregate each partition, writing its groups back over its own pairs
+    SimpelVector<size_t> group_counts;
+    group_counts.resize(parts + 1);
+    parallel_for(parts, [&](size_t begin, size_t end) {
+        SimpelVector<Key> slot_keys;
+        SimpelVector<Value> slot_sums;
+        SimpelVector<uint8_t> used;
+        for (size_t part = begin; part < end; ++part) {
+            Key* pair_keys = part_keys.data() + offsets.data()[part];
+            Value* pair_values = part_values.data() + offsets.data()[part];
+            const size_t count = offsets.data()[part + 1] - offsets.data()[part];
+            const size_t mask = std::bit_ceil(2 * count + 1) - 1;
+            slot_keys.resize(mask + 1);
+            slot_sums.resize(mask + 1);
+            used.clear();
+            used.resize(mask + 1, 0);
+            for (size_t i = 0; i < count; ++i) {
+                size_t slot = static_cast<size_t>(hash_of(pair_keys[i])) & mask;
+                while (used.data()[slot] && !(slot_keys.data()[slot] == pair_keys[i])) {
+                    slot = (slot + 1) & mask;
+                }
+                if (!used.data()[slot]) {
+                    used.data()[slot] = 1;
+                    slot_keys.data()[slot] = pair_keys[i];
+                    slot_sums.data()[slot] = pair_values[i];
+                } else {
+                    slot_sums.data()[slot] += pair_values[i];
+                }
+            }
+            size_t groups = 0;
+            for (size_t slot = 0; slot <= mask; ++slot) {
+                if (used.data()[slot]) {
+                    pair_keys[groups] = slot_keys.data()[slot];
+                    pair_values[groups] = slot_sums.data()[slot];
+                    ++groups;
+                }
+            }
+            group_counts.data()[part] = groups;
+        }
+    }, 1);
+
+    // concatenate the partitions' groups
+    size_t total = 0;
+    for (size_t part = 0; part <= parts; ++part) {
+        const size_t groups = group_counts.data()[part];
+        group_counts.data()[part] = total;
+        total += groups;
+    }
+    result.keys.resize(total);
+    result.sums.resize(total);
+    parallel_for(parts, [&](size_t begin, size_t end) {
+        for (size_t part = begin; part < end; ++part) {
+            const size_t first = offsets.data()[part];
+            const size_t groups = group_counts.data()[part + 1] - group_counts.data()[part];
+            for (size_t g = 0; g < groups; ++g) {
+                result.keys.data()[group_counts.data()[part] + g] = part_keys.data()[first + g];
+                result.sums.data()[group_counts.data()[part] + g] = part_values.data()[first + g];
+            }
+        }
+    }, 1);
+    return result;
+}
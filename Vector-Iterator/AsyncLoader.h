@@ -0,0 +1,581 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__) && !defined(SIMPEL_NO_IO_URING)
+#define SIMPEL_HAS_IO_URING 1
+#include <atomic>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#endif
+
+#include "SimpelVector.h"
+
+// Load fixed-size records from a file and append them to 'out'.
+// The file is read in blocks through a ring of 'depth' buffers: while the
+// calling thread decodes block k, the reads of blocks k+1 .. k+depth-1 are
+// already in flight, and the buffer of block k is resubmitted for block
+// k+depth as soon as it is decoded. 'out' is reserved once from the file size,
+// so push_back never has to grow the buffer during the load.
+//
+// The reads are issued by the best backend available:
+//  - Linux: io_uring (raw system calls, no liburing needed); define
+//    SIMPEL_NO_IO_URING to leave it out. If the kernel refuses to set up a
+//    ring (old kernel, seccomp), the pread thread below is used instead;
+//  - other POSIX systems, and the Linux fallback: one reader thread that
+//    serves the queued blocks in order with pread;
+//  - Windows: overlapped ReadFile, one OVERLAPPED and event per buffer.
+//
+// decode(const char* record) must return a T built from record_size bytes.
+// A trailing partial record at the end of the file is ignored.
+
+// reads kept in flight by default
+constexpr size_t kLoadQueueDepth = 4;
+
+namespace loader_detail {
+
+#if defined(_WIN32)
+
+// ReadFile on a handle opened with FILE_FLAG_OVERLAPPED: every slot has its own
+// OVERLAPPED, so all of them can be pending at once.
+class OverlappedReader {
+private:
+    struct Slot {
+        OVERLAPPED overlapped;
+        size_t bytes = 0;
+        bool pending = false;
+    };
+
+    HANDLE m_File;
+    std::unique_ptr<Slot[]> m_Slots;
+    size_t m_Depth;
+    uint64_t m_Size;
+
+public:
+    OverlappedReader(const std::string& path, size_t depth)
+        : m_File(INVALID_HANDLE_VALUE), m_Slots(new Slot[depth]), m_Depth(depth), m_Size(0) {
+        m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_File == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Could not open file: " + path);
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_File, &size)) {
+            CloseHandle(m_File);
+            throw std::runtime_error("Could not stat file: " + path);
+        }
+        m_Size = static_cast<uint64_t>(size.QuadPart);
+        for (size_t slot = 0; slot < depth; ++slot) {
+            std::memset(&m_Slots[slot].overlapped, 0, sizeof(OVERLAPPED));
+            m_Slots[slot].overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        }
+    }
+
+    ~OverlappedReader() {
+        for (size_t slot = 0; slot < m_Depth; ++slot) {
+            if (m_Slots[slot].pending) {
+                DWORD got = 0;
+                CancelIoEx(m_File, &m_Slots[slot].overlapped);
+                GetOverlappedResult(m_File, &m_Slots[slot].overlapped, &got, TRUE);
+            }
+            if (m_Slots[slot].overlapped.hEvent) {
+                CloseHandle(m_Slots[slot].overlapped.hEvent);
+            }
+        }
+        CloseHandle(m_File);
+    }
+
+    OverlappedReader(const OverlappedReader&) = delete;
+    OverlappedReader& operator=(const OverlappedReader&) = delete;
+
+    uint64_t size() const { return m_Size; }
+
+    void submit(size_t slot, char* buffer, uint64_t offset, size_t bytes) {
+        Slot& s = m_Slots[slot];
+        if (!s.overlapped.hEvent) {
+            throw std::runtime_error("Could not create an I/O event");
+        }
+        ResetEvent(s.overlapped.hEvent);
+        s.overlapped.Offset = static_cast<DWORD>(offset);
+        s.overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        s.bytes = bytes;
+        if (!ReadFile(m_File, buffer, static_cast<DWORD>(bytes), nullptr, &s.overlapped)
+            && GetLastError() != ERROR_IO_PENDING) {
+            throw std::runtime_error("ReadFile failed");
+        }
+        s.pending = true;
+    }
+
+    void wait(size_t slot) {
+        Slot& s = m_Slots[slot];
+        DWORD got = 0;
+        const BOOL ok = GetOverlappedResult(m_File, &s.overlapped, &got, TRUE);
+        s.pending = false;
+        if (!ok || got != s.bytes) {
+            throw std::runtime_error("Short read from file");
+        }
+    }
+};
+
+#else
+
+// read-only file descriptor with its size
+class FileDescriptor {
+private:
+    int m_Fd;
+    uint64_t m_Size;
+
+public:
+    explicit FileDescriptor(const std::string& path) : m_Fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC)), m_Size(0) {
+        if (m_Fd < 0) {
+            throw std::runtime_error("Could not open file: " + path);
+        }
+        struct stat info;
+        if (::fstat(m_Fd, &info) != 0) {
+            ::close(m_Fd);
+            throw std::runtime_error("Could not stat file: " + path);
+        }
+        m_Size = static_cast<uint64_t>(info.st_size);
+#if defined(POSIX_FADV_SEQUENTIAL)
+        ::posix_fadvise(m_Fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    }
+
+    ~FileDescriptor() { ::close(m_Fd); }
+
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    int get() const { return m_Fd; }
+    uint64_t size() const { return m_Size; }
+};
+
+// Fallback: one thread serves the submitted slots in order with pread, so it
+// can run up to 'depth' blocks ahead of the decoder.
+class PreadReader {
+private:
+    struct Slot {
+        char* buffer = nullptr;
+        uint64_t offset = 0;
+        size_t bytes = 0;
+        bool done = false;
+        std::exception_ptr error;
+    };
+
+    FileDescriptor m_File;
+    std::unique_ptr<Slot[]> m_Slots;
+    std::deque<size_t> m_Queue;
+    std::mutex m_Mutex;
+    std::condition_variable m_Cv;
+    bool m_Stop;
+    std::thread m_Thread;
+
+    void read_slot(Slot& slot) {
+        size_t done = 0;
+        while (done < slot.bytes) {
+            const ssize_t got = ::pread(m_File.get(), slot.buffer + done, slot.bytes - done,
+                                        static_cast<off_t>(slot.offset + done));
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got < 0) {
+                throw std::system_error(errno, std::generic_category(), "pread failed");
+            }
+            if (got == 0) {
+                throw std::runtime_error("Short read from file");
+            }
+            done += static_cast<size_t>(got);
+        }
+    }
+
+    void run() {
+        for (;;) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Cv.wait(lock, [&]() { return m_Stop || !m_Queue.empty(); });
+                if (m_Stop) {
+                    return;
+                }
+                index = m_Queue.front();
+                m_Queue.pop_front();
+            }
+            std::exception_ptr error;
+            try {
+                read_slot(m_Slots[index]);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Slots[index].error = error;
+                m_Slots[index].done = true;
+            }
+            m_Cv.notify_all();
+        }
+    }
+
+public:
+    PreadReader(const std::string& path, size_t depth)
+        : m_File(path), m_Slots(new Slot[depth]), m_Stop(false), m_Thread([this]() { run(); }) {}
+
+    ~PreadReader() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+        }
+        m_Cv.notify_all();
+        m_Thread.join();
+    }
+
+    PreadReader(const PreadReader&) = delete;
+    PreadReader& operator=(const PreadReader&) = delete;
+
+    uint64_t size() const { return m_File.size(); }
+
+    void submit(size_t slot, char* buffer, uint64_t offset, size_t bytes) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Slots[slot].buffer = buffer;
+            m_Slots[slot].offset = offset;
+            m_Slots[slot].bytes = bytes;
+            m_Slots[slot].done = false;
+            m_Slots[slot].error = nullptr;
+            m_Queue.push_back(slot);
+        }
+        m_Cv.notify_all();
+    }
+
+    void wait(size_t slot) {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Cv.wait(lock, [&]() { return m_Slots[slot].done; });
+        if (m_Slots[slot].error) {
+            std::rethrow_exception(m_Slots[slot].error);
+        }
+    }
+};
+
+#if defined(SIMPEL_HAS_IO_URING)
+
+// io_uring through the raw system calls: one READV per slot, tagged with the
+// slot index. Short reads are resubmitted for the remainder. ok() is false if
+// the kernel does not provide a ring; the caller then falls back to pread.
+class IoUringReader {
+private:
+    struct Slot {
+        iovec iov{};
+        uint64_t offset = 0;
+        bool pending = false;
+        int error = 0;
+    };
+
+    FileDescriptor m_File;
+    std::unique_ptr<Slot[]> m_Slots;
+    int m_Ring;
+    void* m_SqMap;
+    size_t m_SqMapBytes;
+    void* m_CqMap;
+    size_t m_CqMapBytes;
+    io_uring_sqe* m_Sqes;
+    size_t m_SqesBytes;
+    unsigned* m_SqTail;
+    unsigned* m_SqMask;
+    unsigned* m_SqArray;
+    unsigned* m_CqHead;
+    unsigned* m_CqTail;
+    unsigned* m_CqMask;
+    io_uring_cqe* m_Cqes;
+    size_t m_InFlight;
+
+    static unsigned* at(void* map, unsigned offset) {
+        return reinterpret_cast<unsigned*>(static_cast<char*>(map) + offset);
+    }
+
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+        for (;;) {
+            const long result = ::syscall(__NR_io_uring_enter, m_Ring, to_submit, min_complete, flags, nullptr, 0);
+            if (result >= 0 || errno != EINTR) {
+                return static_cast<int>(result);
+            }
+        }
+    }
+
+    void push(size_t slot) {
+        Slot& s = m_Slots[slot];
+        const unsigned tail = *m_SqTail;
+        const unsigned index = tail & *m_SqMask;
+        io_uring_sqe* sqe = m_Sqes + index;
+        std::memset(sqe, 0, sizeof(io_uring_sqe));
+        sqe->opcode = IORING_OP_READV;
+        sqe->fd = m_File.get();
+        sqe->addr = reinterpret_cast<uint64_t>(&s.iov);
+        sqe->len = 1;
+        sqe->off = s.offset;
+        sqe->user_data = slot;
+        m_SqArray[index] = index;
+        std::atomic_ref<unsigned>(*m_SqTail).store(tail + 1, std::memory_order_release);
+        if (enter(1, 0, 0) < 0) {
+            throw std::system_error(errno, std::generic_category(), "io_uring_enter failed");
+        }
+        s.pending = true;
+        ++m_InFlight;
+    }
+
+    // handle every completion that is already posted
+    void reap() {
+        unsigned head = *m_CqHead;
+        const unsigned tail = std::atomic_ref<unsigned>(*m_CqTail).load(std::memory_order_acquire);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = m_Cqes[head & *m_CqMask];
+            Slot& s = m_Slots[static_cast<size_t>(cqe.user_data)];
+            s.pending = false;
+            --m_InFlight;
+            if (cqe.res < 0) {
+                s.error = -cqe.res;
+            } else if (cqe.res == 0 && s.iov.iov_len > 0) {
+                s.error = -1; // end of file before the block was complete
+            } else {
+                s.iov.iov_base = static_cast<char*>(s.iov.iov_base) + cqe.res;
+                s.iov.iov_len -= static_cast<size_t>(cqe.res);
+                s.offset += static_cast<uint64_t>(cqe.res);
+            }
+        }
+        std::atomic_ref<unsigned>(*m_CqHead).store(head, std::memory_order_release);
+    }
+
+    void release() {
+        if (m_Sqes) {
+            ::munmap(m_Sqes, m_SqesBytes);
+        }
+        if (m_CqMap && m_CqMap != m_SqMap) {
+            ::munmap(m_CqMap, m_CqMapBytes);
+        }
+        if (m_SqMap) {
+            ::munmap(m_SqMap, m_SqMapBytes);
+        }
+        if (m_Ring >= 0) {
+            ::close(m_Ring);
+        }
+        m_Ring = -1;
+    }
+
+public:
+    IoUringReader(const std::string& path, size_t depth)
+        : m_File(path), m_Slots(new Slot[depth]), m_Ring(-1), m_SqMap(nullptr), m_SqMapBytes(0),
+          m_CqMap(nullptr), m_CqMapBytes(0), m_Sqes(nullptr), m_SqesBytes(0), m_SqTail(nullptr),
+          m_SqMask(nullptr), m_SqArray(nullptr), m_CqHead(nullptr), m_CqTail(nullptr), m_CqMask(nullptr),
+          m_Cqes(nullptr), m_InFlight(0) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        m_Ring = static_cast<int>(::syscall(__NR_io_uring_setup, static_cast<unsigned>(depth), &params));
+        if (m_Ring < 0) {
+            return;
+        }
+        m_SqMapBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_CqMapBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_map = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_map) {
+            m_SqMapBytes = m_SqMapBytes > m_CqMapBytes ? m_SqMapBytes : m_CqMapBytes;
+        }
+        void* sq = ::mmap(nullptr, m_SqMapBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Ring, IORING_OFF_SQ_RING);
+        if (sq == MAP_FAILED) {
+            release();
+            return;
+        }
+        m_SqMap = sq;
+        void* cq = single_map ? sq
+            : ::mmap(nullptr, m_CqMapBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Ring, IORING_OFF_CQ_RING);
+        if (cq == MAP_FAILED) {
+            release();
+            return;
+        }
+        m_CqMap = cq;
+        m_SqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, m_SqesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Ring, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            release();
+            return;
+        }
+        m_Sqes = static_cast<io_uring_sqe*>(sqes);
+        m_SqTail = at(sq, params.sq_off.tail);
+        m_SqMask = at(sq, params.sq_off.ring_mask);
+        m_SqArray = at(sq, params.sq_off.array);
+        m_CqHead = at(cq, params.cq_off.head);
+        m_CqTail = at(cq, params.cq_off.tail);
+        m_CqMask = at(cq, params.cq_off.ring_mask);
+        m_Cqes = reinterpret_cast<io_uring_cqe*>(static_cast<char*>(cq) + params.cq_off.cqes);
+    }
+
+    ~IoUringReader() {
+        // the kernel may still write into the buffers: wait for every read
+        while (m_Ring >= 0 && m_InFlight > 0) {
+            reap();
+            if (m_InFlight > 0 && enter(0, 1, IORING_ENTER_GETEVENTS) < 0) {
+                break;
+            }
+        }
+        release();
+    }
+
+    IoUringReader(const IoUringReader&) = delete;
+    IoUringReader& operator=(const IoUringReader&) = delete;
+
+    bool ok() const { return m_Ring >= 0; }
+    uint64_t size() const { return m_File.size(); }
+
+    void submit(size_t slot, char* buffer, uint64_t offset, size_t bytes) {
+        Slot& s = m_Slots[slot];
+        s.iov.iov_base = buffer;
+        s.iov.iov_len = bytes;
+        s.offset = offset;
+        s.error = 0;
+        push(slot);
+    }
+
+    void wait(size_t slot) {
+        Slot& s = m_Slots[slot];
+        for (;;) {
+            reap();
+            if (s.error > 0) {
+                throw std::system_error(s.error, std::generic_category(), "io_uring read failed");
+            }
+            if (s.error < 0) {
+                throw std::runtime_error("Short read from file");
+            }
+            if (!s.pending) {
+                if (s.iov.iov_len == 0) {
+                    return;
+                }
+                push(slot); // short read: ask for the rest
+            } else if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0) {
+                throw std::system_error(errno, std::generic_category(), "io_uring_enter failed");
+            }
+        }
+    }
+};
+
+#endif // SIMPEL_HAS_IO_URING
+#endif // _WIN32
+
+// the ring of buffers: block k is read into slot k % depth
+template <typename Reader, typename T, typename Decode>
+void load_blocks(Reader& reader, char* buffers, SimpelVector<T>& out, Decode& decode,
+                 size_t record_size, size_t block_size, size_t depth) {
+    const uint64_t records = reader.size() / record_size;
+    const uint64_t total_bytes = records * record_size;
+    const uint64_t block_count = (total_bytes + block_size - 1) / block_size;
+    out.reserve(out.size() + static_cast<size_t>(records));
+
+    const auto block_bytes = [&](uint64_t k) {
+        const uint64_t offset = k * block_size;
+        return static_cast<size_t>(total_bytes - offset < block_size ? total_bytes - offset : block_size);
+    };
+    for (uint64_t k = 0; k < block_count && k < depth; ++k) {
+        reader.submit(static_cast<size_t>(k), buffers + k * block_size, k * block_size, block_bytes(k));
+    }
+    for (uint64_t k = 0; k < block_count; ++k) {
+        const size_t slot = static_cast<size_t>(k % depth);
+        char* data = buffers + slot * block_size;
+        reader.wait(slot);
+        const size_t bytes = block_bytes(k);
+        for (size_t offset = 0; offset < bytes; offset += record_size) {
+            out.push_back(decode(data + offset));
+        }
+        if (k + depth < block_count) {
+            reader.submit(slot, data, (k + depth) * block_size, block_bytes(k + depth));
+        }
+    }
+}
+
+} // namespace loader_detail
+
+// Name of the backend load_records_async uses on this system
+inline const char* async_load_backend() {
+#if defined(_WIN32)
+    return "overlapped I/O";
+#else
+#if defined(SIMPEL_HAS_IO_URING)
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    const int ring = static_cast<int>(::syscall(__NR_io_uring_setup, 1u, &params));
+    if (ring >= 0) {
+        ::close(ring);
+        return "io_uring";
+    }
+#endif
+    return "pread thread";
+#endif
+}
+
+template <typename T, typename Decode>
+void load_records_async(const std::string& path, SimpelVector<T>& out, Decode decode,
+                        size_t record_size = sizeof(T), size_t block_size = 1 << 20,
+                        size_t depth = kLoadQueueDepth) {
+    if (record_size == 0) {
+        throw std::invalid_argument("Record size must not be zero");
+    }
+    if (depth == 0) {
+        throw std::invalid_argument("Queue depth must not be zero");
+    }
+
+    // blocks always hold whole records, so a record never straddles two blocks
+    block_size = block_size < record_size ? record_size : block_size - block_size % record_size;
+
+    // declared before the readers: their destructors wait for in-flight reads
+    std::unique_ptr<char[]> buffers(new char[depth * block_size]);
+
+#if defined(_WIN32)
+    loader_detail::OverlappedReader reader(path, depth);
+    loader_detail::load_blocks(reader, buffers.get(), out, decode, record_size, block_size, depth);
+#else
+#if defined(SIMPEL_HAS_IO_URING)
+    {
+        loader_detail::IoUringReader ring(path, depth);
+        if (ring.ok()) {
+            loader_detail::load_blocks(ring, buffers.get(), out, decode, record_size, block_size, depth);
+            return;
+        }
+    }
+#endif
+    loader_detail::PreadReader reader(path, depth);
+    loader_detail::load_blocks(reader, buffers.get(), out, decode, record_size, block_size, depth);
+#endif
+}
+
+// Load a file of raw, trivially copyable T values (as written by fwrite/ofstream::write).
+template <typename T>
+void load_binary_async(const std::string& path, SimpelVector<T>& out, size_t block_size = 1 << 20,
+                       size_t depth = kLoadQueueDepth) {
+    static_assert(std::is_trivially_copyable<T>::value, "load_binary_async requires a trivially copyable T");
+    load_records_async(path, out, [](const char* record) {
+        T value;
+        std::memcpy(&value, record, sizeof(T));
+        return value;
+    }, sizeof(T), block_size, depth);
+}
@@ -0,0 +1,442 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "SimpelVector.h"
+#include "StaticVector.h"
+#include "SortedSearch.h"
+
+// B+-tree map from Key to Value for ordered lookups and range scans.
+// Leaves hold up to LeafCapacity sorted (key, value) pairs in two StaticVectors
+// and are linked left to right, so a range scan walks contiguous arrays.
+// Inner nodes hold up to InnerCapacity separator keys; keys[i] is the smallest
+// key under children[i + 1]. Within a node, keys are searched with sorted_rank().
+//
+// Nodes come from two pools (SimpelVector<Leaf>, SimpelVector<Inner>) and refer
+// to each other by 32-bit index. Allocating a node is a push_back into its pool,
+// and the whole tree is freed with two deallocations.
+// erase() removes the pair from its leaf but does not merge underfull nodes;
+// empty leaves stay linked and are skipped by iteration.
+template <typename Key, typename Value, size_t LeafCapacity = 64, size_t InnerCapacity = 64>
+class BPlusTree {
+    static_assert(LeafCapacity >= 2 && InnerCapacity >= 2, "Nodes need room for at least two entries");
+
+private:
+    static constexpr uint32_t kNone = 0xFFFFFFFF;
+    static constexpr size_t kMaxHeight = 48;
+
+    struct Leaf {
+        StaticVector<Key, LeafCapacity> keys;
+        StaticVector<Value, LeafCapacity> values;
+        uint32_t next = kNone; // right neighbour
+    };
+
+    struct Inner {
+        StaticVector<Key, InnerCapacity> keys;
+        StaticVector<uint32_t, InnerCapacity + 1> children; // leaves if this is the lowest inner level
+    };
+
+    SimpelVector<Leaf> m_Leaves;  // leaf pool
+    SimpelVector<Inner> m_Inners; // inner node pool
+    uint32_t m_Root;
+    size_t m_Height;              // inner levels above the leaves
+    size_t m_Size;
+
+    uint32_t new_leaf() {
+        if (m_Leaves.size() >= kNone) {
+            throw std::length_error("BPlusTree node pool is full");
+        }
+        m_Leaves.push_back(Leaf());
+        return static_cast<uint32_t>(m_Leaves.size() - 1);
+    }
+
+    uint32_t new_inner() {
+        if (m_Inners.size() >= kNone) {
+            throw std::length_error("BPlusTree node pool is full");
+        }
+        m_Inners.push_back(Inner());
+        return static_cast<uint32_t>(m_Inners.size() - 1);
+    }
+
+    // Make room for 'leaves' and 'inners' more nodes (doubling like push_back),
+    // so the new_leaf()/new_inner() calls of one split can no longer throw.
+    void reserve_nodes(size_t leaves, size_t inners) {
+        if (m_Leaves.size() + leaves > kNone || m_Inners.size() + inners > kNone) {
+            throw std::length_error("BPlusTree node pool is full");
+        }
+        if (m_Leaves.size() + leaves > m_Leaves.capacity()) {
+            const size_t doubled = m_Leaves.capacity() * 2;
+            m_Leaves.reserve(doubled > m_Leaves.size() + leaves ? doubled : m_Leaves.size() + leaves);
+        }
+        if (m_Inners.size() + inners > m_Inners.capacity()) {
+            const size_t doubled = m_Inners.capacity() * 2;
+            m_Inners.reserve(doubled > m_Inners.size() + inners ? doubled : m_Inners.size() + inners);
+        }
+    }
+
+    // leaf that holds (or would hold) 'key'
+    uint32_t find_leaf(const Key& key) const {
+        uint32_t node = m_Root;
+        for (size_t level = 0; level < m_Height; ++level) {
+            const Inner& inner = m_Inners.data()[node];
+            node = inner.children.data()[sorted_rank<true>(inner.keys.data(), inner.keys.size(), key)];
+        }
+        return node;
+    }
+
+public:
+    // Forward iterator over (key, value) pairs in key order, following the leaf links
+    class ConstIterator {
+    private:
+        const BPlusTree* m_Tree;
+        uint32_t m_Leaf;
+        size_t m_Position;
+
+        // step over exhausted (or empty) leaves
+        void settle() {
+            while (m_Leaf != kNone && m_Position >= m_Tree->m_Leaves.data()[m_Leaf].keys.size()) {
+                m_Leaf = m_Tree->m_Leaves.data()[m_Leaf].next;
+                m_Position = 0;
+            }
+        }
+
+    public:
+        ConstIterator() : m_Tree(nullptr), m_Leaf(kNone), m_Position(0) {}
+        ConstIterator(const BPlusTree* tree, uint32_t leaf, size_t position) : m_Tree(tree), m_Leaf(leaf), m_Position(position) {
+            settle();
+        }
+
+        const Key& key() const { return m_Tree->m_Leaves.data()[m_Leaf].keys.data()[m_Position]; }
+        const Value& value() const { return m_Tree->m_Leaves.data()[m_Leaf].values.data()[m_Position]; }
+
+        ConstIterator& operator++() {
+            ++m_Position;
+            settle();
+            return *this;
+        }
+
+        bool operator==(const ConstIterator& other) const { return m_Leaf == other.m_Leaf && m_Position == other.m_Position; }
+        bool operator!=(const ConstIterator& other) const { return !(*this == other); }
+    };
+
+    BPlusTree() : m_Root(kNone), m_Height(0), m_Size(0) {}
+
+    // Build from strictly increasing keys and their values, bottom-up in O(n):
+    // leaves get 'leaf_fill' pairs each (full by default, which is best for
+    // scans; leave slack if many inserts follow), then each inner level groups
+    // the level below it.
+    static BPlusTree bulk_load(const SimpelVector<Key>& keys, const SimpelVector<Value>& values, size_t leaf_fill = LeafCapacity) {
+        if (keys.size() != values.size()) {
+            throw std::invalid_argument("bulk_load needs one value per key");
+        }
+        if (leaf_fill == 0 || leaf_fill > LeafCapacity) {
+            throw std::invalid_argument("Leaf fill must be between 1 and the leaf capacity");
+        }
+        for (size_t i = 1; i < keys.size(); ++i) {
+            if (!(keys.data()[i - 1] < keys.data()[i])) {
+                throw std::invalid_argument("Keys must be strictly increasing");
+            }
+        }
+
+        BPlusTree tree;
+        const size_t n = keys.size();
+        if (n == 0) {
+            return tree;
+        }
+
+        // leaves: spread n pairs evenly over ceil(n / leaf_fill) leaves
+        const size_t leaf_count = (n + leaf_fill - 1) / leaf_fill;
+        tree.m_Leaves.reserve(leaf_count);
+        SimpelVector<uint32_t> level;   // nodes of the level being grouped
+        SimpelVector<Key> level_min;    // smallest key under each of them
+        level.reserve(leaf_count);
+        level_min.reserve(leaf_count);
+        for (size_t l = 0; l < leaf_count; ++l) {
+            const size_t begin = n * l / leaf_count;
+            const size_t end = n * (l + 1) / leaf_count;
+            const uint32_t id = tree.new_leaf();
+            Leaf& leaf = tree.m_Leaves.data()[id];
+            for (size_t i = begin; i < end; ++i) {
+                leaf.keys.push_back(keys.data()[i]);
+                leaf.values.push_back(values.data()[i]);
+            }
+            leaf.next = l + 1 < leaf_count ? id + 1 : kNone;
+            level.push_back(id);
+            level_min.push_back(keys.data()[begin]);
+        }
+
+        // inner levels: up to InnerCapacity + 1 children per node, spread evenly
+        while (level.size() > 1) {
+            const size_t count = level.size();
+            const size_t inner_count = (count + InnerCapacity) / (InnerCapacity + 1);
+            SimpelVector<uint32_t> parents;
+            SimpelVector<Key> parents_min;
+            parents.reserve(inner_count);
+            parents_min.reserve(inner_count);
+            for (size_t p = 0; p < inner_count; ++p) {
+                const size_t begin = count * p / inner_count;
+                const size_t end = count * (p + 1) / inner_count;
+                const uint32_t id = tree.new_inner();
+                Inner& inner = tree.m_Inners.data()[id];
+                for (size_t c = begin; c < end; ++c) {
+                    if (c > begin) {
+                        inner.keys.push_back(level_min.data()[c]);
+                    }
+                    inner.children.push_back(level.data()[c]);
+                }
+                parents.push_back(id);
+                parents_min.push_back(level_min.data()[begin]);
+            }
+            level.swap(parents);
+            level_min.swap(parents_min);
+            ++tree.m_Height;
+        }
+        tree.m_Root = level.data()[0];
+        tree.m_Size = n;
+        return tree;
+    }
+
+    // Insert or overwrite; returns true if 'key' was new.
+    // If it throws (std::length_error when the tree would get too deep or a
+    // node pool is full, or an allocation failure), the tree is unchanged.
+    bool insert(const Key& key, const Value& value) {
+        if (m_Root == kNone) {
+            m_Root = new_leaf();
+        }
+
+        // descend, remembering the path for splits
+        StaticVector<uint32_t, kMaxHeight> path;
+        StaticVector<size_t, kMaxHeight> slots;
+        uint32_t node = m_Root;
+        for (size_t level = 0; level < m_Height; ++level) {
+            const Inner& inner = m_Inners.data()[node];
+            const size_t slot = sorted_rank<true>(inner.keys.data(), inner.keys.size(), key);
+            path.push_back(node);
+            slots.push_back(slot);
+            node = inner.children.data()[slot];
+        }
+
+        {
+            Leaf& leaf = m_Leaves.data()[node];
+            const size_t position = sorted_rank<false>(leaf.keys.data(), leaf.keys.size(), key);
+            if (position < leaf.keys.size() && !(key < leaf.keys.data()[position])) {
+                leaf.values.data()[position] = value;
+                return false;
+            }
+            if (!leaf.keys.full()) {
+                leaf.keys.insert(position, key);
+                leaf.values.insert(position, value);
+                ++m_Size;
+                return true;
+            }
+        }
+
+        // Count the nodes the split needs (the leaf, every full inner node above
+        // it, and a new root if the split reaches it) and allocate room for them
+        // before anything is modified.
+        size_t full_levels = 0;
+        while (full_levels < path.size() && m_Inners.data()[path.data()[path.size() - 1 - full_levels]].keys.full()) {
+            ++full_levels;
+        }
+        const bool root_splits = full_levels == path.size();
+        if (root_splits && m_Height + 1 >= kMaxHeight) {
+            throw std::length_error("BPlusTree is too deep");
+        }
+        reserve_nodes(1, full_levels + (root_splits ? 1 : 0));
+
+        // split the full leaf in half and put the new pair on its side
+        const uint32_t right = new_leaf(); // may move the pool: re-fetch references below
+        {
+            Leaf& left_leaf = m_Leaves.data()[node];
+            Leaf& right_leaf = m_Leaves.data()[right];
+            const size_t half = LeafCapacity / 2;
+            for (size_t i = half; i < LeafCapacity; ++i) {
+                right_leaf.keys.push_back(left_leaf.keys.data()[i]);
+                right_leaf.values.push_back(left_leaf.values.data()[i]);
+            }
+            left_leaf.keys.resize(half);
+            left_leaf.values.resize(half);
+            right_leaf.next = left_leaf.next;
+            left_leaf.next = right;
+
+            const size_t position = sorted_rank<false>(left_leaf.keys.data(), half, key);
+            if (position < half) {
+                left_leaf.keys.insert(position, key);
+                left_leaf.values.insert(position, value);
+            } else {
+                const size_t right_position = sorted_rank<false>(right_leaf.keys.data(), right_leaf.keys.size(), key);
+                right_leaf.keys.insert(right_position, key);
+                right_leaf.values.insert(right_position, value);
+            }
+        }
+        Key separator = m_Leaves.data()[right].keys.data()[0];
+        uint32_t new_child = right;
+
+        // push (separator, new_child) up, splitting full inner nodes on the way
+        while (!path.empty()) {
+            const uint32_t parent = path.data()[path.size() - 1];
+            const size_t slot = slots.data()[slots.size() - 1];
+            path.pop_back();
+            slots.pop_back();
+
+            Inner& inner = m_Inners.data()[parent];
+            if (!inner.keys.full()) {
+                inner.keys.insert(slot, separator);
+                inner.children.insert(slot + 1, new_child);
+                ++m_Size;
+                return true;
+            }
+
+            // full: merge into temporaries one entry larger, then split around the middle key
+            StaticVector<Key, InnerCapacity + 1> all_keys;
+            StaticVector<uint32_t, InnerCapacity + 2> all_children;
+            for (size_t i = 0; i < inner.keys.size(); ++i) {
+                all_keys.push_back(inner.keys.data()[i]);
+            }
+            for (size_t i = 0; i < inner.children.size(); ++i) {
+                all_children.push_back(inner.children.data()[i]);
+            }
+            all_keys.insert(slot, separator);
+            all_children.insert(slot + 1, new_child);
+
+            const size_t middle = all_keys.size() / 2;
+            const uint32_t sibling = new_inner(); // may move the pool
+            Inner& left_inner = m_Inners.data()[parent];
+            Inner& right_inner = m_Inners.data()[sibling];
+            left_inner.keys.clear();
+            left_inner.children.clear();
+            for (size_t i = 0; i < middle; ++i) {
+                left_inner.keys.push_back(all_keys.data()[i]);
+            }
+            for (size_t i = 0; i <= middle; ++i) {
+                left_inner.children.push_back(all_children.data()[i]);
+            }
+            for (size_t i = middle + 1; i < all_keys.size(); ++i) {
+                right_inner.keys.push_back(all_keys.data()[i]);
+            }
+            for (size_t i = middle + 1; i < all_children.size(); ++i) {
+                right_inner.children.push_back(all_children.data()[i]);
+            }
+            separator = all_keys.data()[middle];
+            new_child = sibling;
+        }
+
+        // the root split: grow the tree by one level
+        const uint32_t root = new_inner();
+        Inner& new_root = m_Inners.data()[root];
+        new_root.keys.push_back(separator);
+        new_root.children.push_back(m_Root);
+        new_root.children.push_back(new_child);
+        m_Root = root;
+        ++m_Height;
+        ++m_Size;
+        return true;
+    }
+
+    // remove 'key'; returns whether it was present (nodes are not merged)
+    bool erase(const Key& key) {
+        if (m_Root == kNone) {
+            return false;
+        }
+        Leaf& leaf = m_Leaves.data()[find_leaf(key)];
+        const size_t position = sorted_rank<false>(leaf.keys.data(), leaf.keys.size(), key);
+        if (position == leaf.keys.size() || key < leaf.keys.data()[position]) {
+            return false;
+        }
+        leaf.keys.erase(position);
+        leaf.values.erase(position);
+        --m_Size;
+        return true;
+    }
+
+    // pointer to the value of 'key', or nullptr (valid until the next insert)
+    const Value* find(const Key& key) const {
+        if (m_Root == kNone) {
+            return nullptr;
+        }
+        const Leaf& leaf = m_Leaves.data()[find_leaf(key)];
+        const size_t position = sorted_rank<false>(leaf.keys.data(), leaf.keys.size(), key);
+        if (position == leaf.keys.size() || key < leaf.keys.data()[position]) {
+            return nullptr;
+        }
+        return leaf.values.data() + position;
+    }
+
+    Value* find(const Key& key) { return const_cast<Value*>(static_cast<const BPlusTree*>(this)->find(key)); }
+
+    bool contains(const Key& key) const { return find(key) != nullptr; }
+
+    // first pair with a key >= 'key'
+    ConstIterator lower_bound(const Key& key) const {
+        if (m_Root == kNone) {
+            return end();
+        }
+        const uint32_t leaf = find_leaf(key);
+        const Leaf& node = m_Leaves.data()[leaf];
+        return ConstIterator(this, leaf, sorted_rank<false>(node.keys.data(), node.keys.size(), key));
+    }
+
+    // call fn(key, value) for every pair with first <= key < last, in order;
+    // walks each leaf's key and value arrays directly
+    template <typename F>
+    void for_each_in_range(const Key& first, const Key& last, F fn) const {
+        if (m_Root == kNone) {
+            return;
+        }
+        uint32_t leaf = find_leaf(first);
+        size_t position = sorted_rank<false>(m_Leaves.data()[leaf].keys.data(), m_Leaves.data()[leaf].keys.size(), first);
+        while (leaf != kNone) {
+            const Leaf& node = m_Leaves.data()[leaf];
+            const Key* keys = node.keys.data();
+            const Value* values = node.values.data();
+            for (; position < node.keys.size(); ++position) {
+                if (!(keys[position] < last)) {
+                    return;
+                }
+                fn(keys[position], values[position]);
+            }
+            leaf = node.next;
+            position = 0;
+        }
+    }
+
+    ConstIterator begin() const {
+        if (m_Root == kNone) {
+            return end();
+        }
+        // leftmost leaf: follow the first child down
+        uint32_t node = m_Root;
+        for (size_t level = 0; level < m_Height; ++level) {
+            node = m_Inners.data()[node].children.data()[0];
+        }
+        return ConstIterator(this, node, 0);
+    }
+
+    ConstIterator end() const { return ConstIterator(this, kNone, 0); }
+
+    void swap(BPlusTree& other) noexcept {
+        m_Leaves.swap(other.m_Leaves);
+        m_Inners.swap(other.m_Inners);
+        std::swap(m_Root, other.m_Root);
+        std::swap(m_Height, other.m_Height);
+        std::swap(m_Size, other.m_Size);
+    }
+
+    void clear() {
+        m_Leaves.clear();
+        m_Inners.clear();
+        m_Root = kNone;
+        m_Height = 0;
+        m_Size = 0;
+    }
+
+    // accessors
+    size_t size() const { return m_Size; }
+    bool empty() const { return m_Size == 0; }
+    size_t height() const { return m_Height + (m_Root == kNone ? 0 : 1); } // levels including the leaves
+    size_t node_bytes() const { return m_Leaves.capacity() * sizeof(Leaf) + m_Inners.capacity() * sizeof(Inner); }
+};
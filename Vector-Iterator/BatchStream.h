@@ -0,0 +1,274 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+#include <utility>
+
+#include "SimpelVector.h"
+
+// Minimal C++20 coroutine generator.
+// co_yield hands out a reference to the yielded object, so a stage can keep
+// refilling one buffer instead of returning a fresh one per element.
+template <typename T>
+class Generator {
+public:
+    struct promise_type {
+        T* m_Value = nullptr;       // points at the value of the last co_yield
+        std::exception_ptr m_Error; // exception that escaped the coroutine body
+
+        Generator get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        // lvalue yield: the caller sees (and may modify) the coroutine's own object
+        std::suspend_always yield_value(T& value) noexcept {
+            m_Value = std::addressof(value);
+            return {};
+        }
+        // rvalue yield: the temporary lives until the coroutine is resumed
+        std::suspend_always yield_value(T&& value) noexcept {
+            m_Value = std::addressof(value);
+            return {};
+        }
+
+        void return_void() {}
+        void unhandled_exception() { m_Error = std::current_exception(); }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    // Input iterator over the yielded values
+    class Iterator {
+    private:
+        Handle m_Handle;
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() : m_Handle(nullptr) {}
+        explicit Iterator(Handle handle) : m_Handle(handle) {}
+        T& operator*() const { return *m_Handle.promise().m_Value; }
+        Iterator& operator++() { advance(m_Handle); return *this; }
+        void operator++(int) { ++*this; }
+        bool operator==(std::default_sentinel_t) const { return !m_Handle || m_Handle.done(); }
+    };
+
+    explicit Generator(Handle handle) : m_Handle(handle) {}
+
+    // generators own a coroutine frame: movable, not copyable
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+    Generator(Generator&& other) noexcept : m_Handle(std::exchange(other.m_Handle, nullptr)) {}
+    Generator& operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            if (m_Handle) {
+                m_Handle.destroy();
+            }
+            m_Handle = std::exchange(other.m_Handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~Generator() {
+        if (m_Handle) {
+            m_Handle.destroy();
+        }
+    }
+
+    // begin() runs the coroutine up to its first co_yield
+    Iterator begin() {
+        advance(m_Handle);
+        return Iterator(m_Handle);
+    }
+    std::default_sentinel_t end() const { return {}; }
+
+private:
+    Handle m_Handle;
+
+    // resume until the next co_yield (or the end) and rethrow errors from the body
+    static void advance(Handle handle) {
+        if (!handle || handle.done()) {
+            return;
+        }
+        handle.resume();
+        if (handle.promise().m_Error) {
+            std::rethrow_exception(std::exchange(handle.promise().m_Error, nullptr));
+        }
+    }
+};
+
+// Stream 'source' in batches of at most batch_size elements.
+// The same buffer is cleared and refilled for every batch, so once it has grown
+// to batch_size no further allocation happens.
+template <typename T>
+Generator<SimpelVector<T>> batches(const SimpelVector<T>& source, size_t batch_size) {
+    if (batch_size == 0) {
+        throw std::invalid_argument("Batch size must not be zero");
+    }
+    SimpelVector<T> batch;
+    batch.reserve(batch_size);
+    for (size_t i = 0; i < source.size(); i += batch_size) {
+        batch.clear();
+        for (size_t j = i; j < source.size() && j < i + batch_size; ++j) {
+            batch.push_back(source[j]);
+        }
+        co_yield batch;
+    }
+}
+
+// Bounded producer/consumer channel for batches.
+// The channel owns 'capacity' buffers that circulate between producer and
+// consumer by swapping (SimpelVector::swap), never by copying or reallocating:
+//
+//   producer: acquire(batch) -> fill batch -> send(batch)
+//   consumer: receive(batch) -> use batch  -> release(batch)
+//
+// acquire() blocks while all buffers are in flight, which is the backpressure
+// that keeps a fast producer from running ahead of the consumer.
+template <typename T>
+class BatchChannel {
+private:
+    size_t m_Capacity;
+    std::unique_ptr<SimpelVector<T>[]> m_Free; // stack of empty buffers (retained capacity)
+    std::unique_ptr<SimpelVector<T>[]> m_Full; // ring of sent batches waiting for the consumer
+    size_t m_FreeCount;
+    size_t m_FullHead; // index of the oldest sent batch
+    size_t m_FullCount;
+    bool m_Closed;
+    std::exception_ptr m_Error; // producer failure, rethrown by receive() once drained
+    std::mutex m_Mutex;
+    std::condition_variable m_FreeAvailable;
+    std::condition_variable m_FullAvailable;
+
+public:
+    // capacity: number of buffers in circulation
+    // batch_capacity: capacity reserved up front for each buffer
+    explicit BatchChannel(size_t capacity, size_t batch_capacity = 0)
+        : m_Capacity(capacity), m_Free(new SimpelVector<T>[capacity]), m_Full(new SimpelVector<T>[capacity]),
+          m_FreeCount(capacity), m_FullHead(0), m_FullCount(0), m_Closed(false) {
+        if (capacity == 0) {
+            throw std::invalid_argument("Channel capacity must not be zero");
+        }
+        for (size_t i = 0; i < capacity; ++i) {
+            m_Free[i].reserve(batch_capacity);
+        }
+    }
+
+    BatchChannel(const BatchChannel&) = delete;
+    BatchChannel& operator=(const BatchChannel&) = delete;
+
+    // Swap an empty recycled buffer into 'batch'. Blocks while none is free.
+    // Returns false if the channel was closed.
+    bool acquire(SimpelVector<T>& batch) {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_FreeAvailable.wait(lock, [this]() { return m_FreeCount > 0 || m_Closed; });
+        if (m_Closed) {
+            return false;
+        }
+        batch.swap(m_Free[--m_FreeCount]);
+        batch.clear();
+        return true;
+    }
+
+    // Hand 'batch' to the consumer. 'batch' is left empty afterwards.
+    // Returns false if the channel was closed.
+    bool send(SimpelVector<T>& batch) {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_FreeAvailable.wait(lock, [this]() { return m_FullCount < m_Capacity || m_Closed; });
+            if (m_Closed) {
+                return false;
+            }
+            m_Full[(m_FullHead + m_FullCount) % m_Capacity].swap(batch);
+            ++m_FullCount;
+        }
+        m_FullAvailable.notify_one();
+        return true;
+    }
+
+    // Swap the oldest sent batch into 'batch'. Blocks until one arrives.
+    // Returns false once the channel is closed and drained, or rethrows the
+    // producer's error if it was closed with one.
+    bool receive(SimpelVector<T>& batch) {
+        bool freed_slot = false;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_FullAvailable.wait(lock, [this]() { return m_FullCount > 0 || m_Closed; });
+            if (m_FullCount == 0) {
+                if (m_Error) {
+                    std::rethrow_exception(m_Error);
+                }
+                return false;
+            }
+            batch.swap(m_Full[m_FullHead]);
+            m_FullHead = (m_FullHead + 1) % m_Capacity;
+            freed_slot = m_FullCount-- == m_Capacity;
+        }
+        if (freed_slot) {
+            m_FreeAvailable.notify_all();
+        }
+        return true;
+    }
+
+    // Return a consumed buffer so the producer can reuse its capacity.
+    void release(SimpelVector<T>& batch) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_FreeCount == m_Capacity) {
+                return; // not one of ours: the channel is already full of free buffers
+            }
+            batch.clear();
+            m_Free[m_FreeCount++].swap(batch);
+        }
+        m_FreeAvailable.notify_all();
+    }
+
+    // No more batches will be sent; receive() drains what is left, then returns
+    // false, or rethrows 'error' if the producer failed.
+    void close(std::exception_ptr error = nullptr) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Closed = true;
+            if (error && !m_Error) {
+                m_Error = error;
+            }
+        }
+        m_FreeAvailable.notify_all();
+        m_FullAvailable.notify_all();
+    }
+};
+
+// Drive a batch generator into a channel.
+// Each yielded batch is swapped with a recycled channel buffer, so the generator
+// keeps refilling buffers whose capacity has already been grown.
+// The channel is closed on every exit; an exception from the generator is handed
+// to the consumer's receive() rather than thrown here, since the producer usually
+// runs on a thread of its own where it would terminate the process.
+template <typename T>
+void stream_to_channel(Generator<SimpelVector<T>>& stream, BatchChannel<T>& channel) {
+    SimpelVector<T> buffer;
+    try {
+        for (SimpelVector<T>& batch : stream) {
+            if (!channel.acquire(buffer)) {
+                break;
+            }
+            buffer.swap(batch); // the generator continues with the recycled (cleared) buffer
+            if (!channel.send(buffer)) {
+                break;
+            }
+        }
+    } catch (...) {
+        channel.close(std::current_exception());
+        return;
+    }
+    channel.close();
+}
@@ -0,0 +1,791 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "SlabAllocator.h"
+#include "NdVector.h"
+#include "GapBuffer.h"
+#include "DaryHeap.h"
+#include "BPlusTree.h"
+#include "EytzingerVector.h"
+#include "LearnedIndex.h"
+#include "PrefixSum.h"
+#include "Aggregate.h"
+#include "RadixPartition.h"
+
+// Small benchmark suite, run with "Vector-Iterator --bench".
+// Numbers are wall-clock milliseconds of a single run: good enough to compare
+// variants on one machine, not a replacement for a statistics-aware harness.
+
+// time a callable in milliseconds
+template <typename F>
+double time_ms(F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+// run f(thread_index) on 'threads' threads and time until all have finished
+template <typename F>
+double time_threads_ms(size_t threads, F f) {
+    return time_ms([&]() {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back(f, t);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    });
+}
+
+inline size_t bench_thread_count() {
+    const size_t threads = std::thread::hardware_concurrency();
+    return threads < 2 ? 2 : threads;
+}
+
+inline void print_result(const char* name, double ms) {
+    std::cout << "  " << std::left << std::setw(36) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << ms << " ms" << std::endl;
+}
+
+// Multi-threaded push_back churn: every thread repeatedly grows a buffer by
+// doubling from 64 bytes to 256 KiB (touching the new half like push_back would),
+// then frees it.
+inline void bench_slab_allocator() {
+    const size_t threads = bench_thread_count();
+    const size_t rounds = 2000;
+    const size_t max_bytes = size_t(256) << 10;
+    std::cout << "Slab allocator: push_back growth churn, " << threads << " threads x " << rounds << " rounds" << std::endl;
+
+    // what SimpelVector::resize_capacity does: new buffer, copy, free old
+    print_result("malloc + copy + free", time_threads_ms(threads, [&](size_t) {
+        for (size_t r = 0; r < rounds; ++r) {
+            size_t bytes = 64;
+            char* data = static_cast<char*>(std::malloc(bytes));
+            std::memset(data, 1, bytes);
+            while (bytes < max_bytes) {
+                char* grown = static_cast<char*>(std::malloc(bytes * 2));
+                std::memcpy(grown, data, bytes);
+                std::memset(grown + bytes, 1, bytes);
+                std::free(data);
+                data = grown;
+                bytes *= 2;
+            }
+            std::free(data);
+        }
+    }));
+
+    print_result("realloc", time_threads_ms(threads, [&](size_t) {
+        for (size_t r = 0; r < rounds; ++r) {
+            size_t bytes = 64;
+            char* data = static_cast<char*>(std::malloc(bytes));
+            std::memset(data, 1, bytes);
+            while (bytes < max_bytes) {
+                data = static_cast<char*>(std::realloc(data, bytes * 2));
+                std::memset(data + bytes, 1, bytes);
+                bytes *= 2;
+            }
+            std::free(data);
+        }
+    }));
+
+    SlabAllocator& slab = SlabAllocator::instance();
+    print_result("slab (try_expand, else copy)", time_threads_ms(threads, [&](size_t) {
+        for (size_t r = 0; r < rounds; ++r) {
+            size_t bytes = 64;
+            char* data = static_cast<char*>(slab.allocate(bytes));
+            std::memset(data, 1, bytes);
+            while (bytes < max_bytes) {
+                if (!slab.try_expand(data, bytes, bytes * 2)) {
+                    char* grown = static_cast<char*>(slab.allocate(bytes * 2));
+                    std::memcpy(grown, data, bytes);
+                    slab.deallocate(data, bytes);
+                    data = grown;
+                }
+                std::memset(data + bytes, 1, bytes);
+                bytes *= 2;
+            }
+            slab.deallocate(data, bytes);
+        }
+    }));
+
+    // the same churn through the vector itself
+    const size_t max_count = max_bytes / sizeof(int);
+    print_result("SimpelVector push_back (new[])", time_threads_ms(threads, [&](size_t) {
+        for (size_t r = 0; r < rounds; ++r) {
+            SimpelVector<int> values;
+            for (size_t i = 0; i < max_count; ++i) {
+                values.push_back(static_cast<int>(i));
+            }
+        }
+    }));
+    print_result("SlabVector push_back", time_threads_ms(threads, [&](size_t) {
+        for (size_t r = 0; r < rounds; ++r) {
+            SlabVector<int> values;
+            for (size_t i = 0; i < max_count; ++i) {
+                values.push_back(static_cast<int>(i));
+            }
+        }
+    }));
+}
+
+// Matrix multiply C = A * B with the same i-k-j loop for every layout, and a
+// naive vs blocked transpose. Shows what the layout alone costs.
+inline void bench_nd_layouts() {
+    const size_t n = 384;
+    std::cout << "NdVector layouts: " << n << "x" << n << " matmul (i-k-j loop)" << std::endl;
+
+    auto matmul = [n](NdLayout layout, const char* name) {
+        NdVector<double, 2> a({ n, n }, layout, 16);
+        NdVector<double, 2> b({ n, n }, layout, 16);
+        NdVector<double, 2> c({ n, n }, layout, 16);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                a(i, j) = static_cast<double>(i + j) / n;
+                b(i, j) = static_cast<double>(i) - static_cast<double>(j);
+            }
+        }
+        print_result(name, time_ms([&]() {
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t k = 0; k < n; ++k) {
+                    const double aik = a(i, k);
+                    for (size_t j = 0; j < n; ++j) {
+                        c(i, j) += aik * b(k, j);
+                    }
+                }
+            }
+        }));
+    };
+    matmul(NdLayout::RowMajor, "row-major");
+    matmul(NdLayout::ColumnMajor, "column-major");
+    matmul(NdLayout::Tiled, "tiled 16x16");
+
+    const size_t m = 2048;
+    std::cout << "NdVector transpose: " << m << "x" << m << " row-major" << std::endl;
+    NdVector<double, 2> src({ m, m });
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < m; ++j) {
+            src(i, j) = static_cast<double>(i * m + j);
+        }
+    }
+    NdVector<double, 2> dst({ m, m });
+    print_result("naive", time_ms([&]() {
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t j = 0; j < m; ++j) {
+                dst(j, i) = src(i, j);
+            }
+        }
+    }));
+    print_result("blocked (transposed)", time_ms([&]() {
+        NdVector<double, 2> result = src.transposed();
+        dst.swap(result);
+    }));
+}
+
+// Random local edits (cursor jumps of at most +-64, then insert or delete a few
+// characters) on a 100 MB text, gap buffer vs inserting into a flat SimpelVector<char>.
+inline void bench_gap_buffer() {
+    const size_t bytes = size_t(100) << 20;
+    const size_t edits = 1000000;
+    const size_t flat_edits = 200; // each flat edit moves ~50 MB: far fewer of them
+    std::cout << "Gap buffer: random local edits on " << (bytes >> 20) << " MB" << std::endl;
+
+    SimpelVector<char> text;
+    text.resize(bytes, 'x');
+
+    GapBuffer<char> buffer;
+    buffer.insert(text.data(), text.size());
+    buffer.move_cursor(bytes / 2);
+
+    std::mt19937_64 rng(42);
+    const char snippet[] = "edit";
+    const double gap_ms = time_ms([&]() {
+        for (size_t e = 0; e < edits; ++e) {
+            const size_t jump = static_cast<size_t>(rng() % 129);
+            size_t position = buffer.cursor() + jump < 64 ? 0 : buffer.cursor() + jump - 64;
+            position = position > buffer.size() ? buffer.size() : position;
+            buffer.move_cursor(position);
+            if (rng() % 2 == 0 || buffer.cursor() < 4) {
+                buffer.insert(snippet, 4);
+            } else {
+                buffer.erase_before(4);
+            }
+        }
+    });
+    std::cout << "  " << std::left << std::setw(36) << "gap buffer" << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << gap_ms * 1e6 / edits << " ns/edit" << std::endl;
+
+    // flat vector: every insert/delete shifts the whole tail (capacity reserved up front)
+    text.reserve(bytes + 4 * flat_edits);
+    size_t cursor = bytes / 2;
+    const double flat_ms = time_ms([&]() {
+        for (size_t e = 0; e < flat_edits; ++e) {
+            const size_t jump = static_cast<size_t>(rng() % 129);
+            cursor = cursor + jump < 64 ? 0 : cursor + jump - 64;
+            cursor = cursor > text.size() ? text.size() : cursor;
+            if (rng() % 2 == 0 || cursor < 4) {
+                const size_t old_size = text.size();
+                text.resize(old_size + 4);
+                std::memmove(text.data() + cursor + 4, text.data() + cursor, old_size - cursor);
+                std::memcpy(text.data() + cursor, snippet, 4);
+                cursor += 4;
+            } else {
+                std::memmove(text.data() + cursor - 4, text.data() + cursor, text.size() - cursor);
+                text.resize(text.size() - 4);
+                cursor -= 4;
+            }
+        }
+    });
+    std::cout << "  " << std::left << std::setw(36) << "flat SimpelVector<char>" << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << flat_ms * 1e6 / flat_edits << " ns/edit" << std::endl;
+}
+
+// Timer-queue "hold" workload: a heap of 1M deadlines, then repeatedly pop the
+// earliest one and re-arm it a random interval later.
+inline void bench_heaps() {
+    const size_t timers = 1000000;
+    const size_t rounds = 5000000;
+    std::cout << "Heaps: " << timers << " timers, " << rounds << " pop + push rounds" << std::endl;
+
+    SimpelVector<uint64_t> initial;
+    std::mt19937_64 rng(42);
+    for (size_t i = 0; i < timers; ++i) {
+        initial.push_back(rng() % 1000000);
+    }
+
+    auto hold = [&](auto& heap, auto top, auto pop, auto push) {
+        std::mt19937_64 local(7);
+        for (size_t i = 0; i < timers; ++i) {
+            push(heap, initial.data()[i]);
+        }
+        uint64_t checksum = 0;
+        for (size_t r = 0; r < rounds; ++r) {
+            const uint64_t now = top(heap);
+            pop(heap);
+            checksum += now;
+            push(heap, now + local() % 1000000);
+        }
+        return checksum;
+    };
+
+    uint64_t checksum = 0;
+    print_result("std::priority_queue", time_ms([&]() {
+        std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> heap;
+        checksum = hold(heap, [](auto& h) { return h.top(); }, [](auto& h) { h.pop(); }, [](auto& h, uint64_t v) { h.push(v); });
+    }));
+    const uint64_t expected = checksum;
+
+    auto run_dary = [&](const char* name, auto heap) {
+        print_result(name, time_ms([&]() {
+            checksum = hold(heap, [](auto& h) { return h.top(); }, [](auto& h) { h.pop(); }, [](auto& h, uint64_t v) { h.push(v); });
+        }));
+    };
+    run_dary("DaryHeap D=2", DaryHeap<uint64_t, 2, std::greater<uint64_t>>());
+    run_dary("DaryHeap D=4", DaryHeap<uint64_t, 4, std::greater<uint64_t>>());
+    run_dary("DaryHeap D=8", DaryHeap<uint64_t, 8, std::greater<uint64_t>>());
+
+    // re-armed deadlines are never earlier than now, so the keys are monotone
+    print_result("RadixHeap", time_ms([&]() {
+        RadixHeap<uint32_t> heap;
+        checksum = hold(heap, [](auto& h) { return h.top_key(); }, [](auto& h) { h.pop(); },
+                        [](auto& h, uint64_t v) { h.push(v, 0); });
+    }));
+    if (checksum != expected) {
+        std::cout << "  checksum mismatch" << std::endl;
+    }
+}
+
+// Ordered index over 2M random uint64 keys: build from sorted input, random
+// point lookups, and range scans of ~1000 keys, for std::map, a sorted flat map
+// (two SimpelVectors + std::lower_bound) and the B+-tree.
+inline void bench_ordered_index() {
+    const size_t n = 2000000;
+    const size_t lookups = 1000000;
+    const size_t scans = 2000;
+    std::cout << "Ordered index: " << n << " keys, " << lookups << " lookups, " << scans << " range scans" << std::endl;
+
+    std::mt19937_64 rng(42);
+    SimpelVector<uint64_t> keys;
+    SimpelVector<uint64_t> values;
+    for (size_t i = 0; i < n; ++i) {
+        keys.push_back(rng() >> 1);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.resize(static_cast<size_t>(std::unique(keys.begin(), keys.end()) - keys.begin()));
+    for (size_t i = 0; i < keys.size(); ++i) {
+        values.push_back(i);
+    }
+    SimpelVector<uint64_t> probes;
+    for (size_t i = 0; i < lookups; ++i) {
+        probes.push_back(keys.data()[rng() % keys.size()]);
+    }
+    const uint64_t scan_width = (uint64_t(1) << 63) / keys.size() * 1000; // ~1000 keys per scan
+
+    uint64_t checksum = 0;
+    auto report = [&](const char* name, double build, double lookup, double scan) {
+        std::cout << "  " << std::left << std::setw(18) << name << std::right << std::fixed << std::setprecision(2)
+                  << " build " << std::setw(8) << build << " ms, lookup " << std::setw(8) << lookup
+                  << " ms, scan " << std::setw(8) << scan << " ms" << std::endl;
+    };
+
+    {
+        std::map<uint64_t, uint64_t> map;
+        const double build = time_ms([&]() {
+            for (size_t i = 0; i < keys.size(); ++i) {
+                map.emplace_hint(map.end(), keys.data()[i], values.data()[i]);
+            }
+        });
+        const double lookup = time_ms([&]() {
+            for (const auto& probe : probes) {
+                checksum += map.find(probe)->second;
+            }
+        });
+        const double scan = time_ms([&]() {
+            for (size_t s = 0; s < scans; ++s) {
+                const uint64_t first = probes.data()[s];
+                for (auto it = map.lower_bound(first); it != map.end() && it->first < first + scan_width; ++it) {
+                    checksum += it->second;
+                }
+            }
+        });
+        report("std::map", build, lookup, scan);
+    }
+    {
+        SimpelVector<uint64_t> flat_keys;
+        SimpelVector<uint64_t> flat_values;
+        const double build = time_ms([&]() {
+            flat_keys.append(keys.data(), keys.size());
+            flat_values.append(values.data(), values.size());
+        });
+        const uint64_t* first_key = flat_keys.data();
+        const uint64_t* last_key = first_key + flat_keys.size();
+        const double lookup = time_ms([&]() {
+            for (const auto& probe : probes) {
+                checksum += flat_values.data()[std::lower_bound(first_key, last_key, probe) - first_key];
+            }
+        });
+        const double scan = time_ms([&]() {
+            for (size_t s = 0; s < scans; ++s) {
+                const uint64_t first = probes.data()[s];
+                for (const uint64_t* it = std::lower_bound(first_key, last_key, first); it != last_key && *it < first + scan_width; ++it) {
+                    checksum += flat_values.data()[it - first_key];
+                }
+            }
+        });
+        report("sorted flat map", build, lookup, scan);
+    }
+    {
+        BPlusTree<uint64_t, uint64_t> tree;
+        const double build = time_ms([&]() {
+            BPlusTree<uint64_t, uint64_t> loaded = BPlusTree<uint64_t, uint64_t>::bulk_load(keys, values);
+            tree.swap(loaded);
+        });
+        const double lookup = time_ms([&]() {
+            for (const auto& probe : probes) {
+                checksum += *tree.find(probe);
+            }
+        });
+        const double scan = time_ms([&]() {
+            for (size_t s = 0; s < scans; ++s) {
+                const uint64_t first = probes.data()[s];
+                tree.for_each_in_range(first, first + scan_width, [&](uint64_t, uint64_t value) { checksum += value; });
+            }
+        });
+        report("B+-tree", build, lookup, scan);
+    }
+    std::cout << "  (checksum " << checksum << ")" << std::endl;
+}
+
+// Random lower_bound queries over 16M sorted uint64 ids (128 MB, beyond the
+// caches): std::lower_bound on the sorted vector vs the Eytzinger layout.
+inline void bench_eytzinger() {
+    const size_t n = size_t(1) << 24;
+    const size_t queries = 5000000;
+    std::cout << "Search layouts: " << n << " sorted keys, " << queries << " lower_bound queries" << std::endl;
+
+    std::mt19937_64 rng(42);
+    SimpelVector<uint64_t> sorted;
+    sorted.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        sorted.push_back(rng());
+    }
+    std::sort(sorted.begin(), sorted.end());
+    SimpelVector<uint64_t> probes;
+    for (size_t i = 0; i < queries; ++i) {
+        probes.push_back(rng());
+    }
+
+    size_t checksum = 0;
+    print_result("std::lower_bound", time_ms([&]() {
+        const uint64_t* first = sorted.data();
+        for (const auto& probe : probes) {
+            checksum += static_cast<size_t>(std::lower_bound(first, first + n, probe) - first);
+        }
+    }));
+    EytzingerVector<uint64_t> layout;
+    print_result("Eytzinger build", time_ms([&]() {
+        EytzingerVector<uint64_t> built(sorted);
+        layout.swap(built);
+    }));
+    print_result("Eytzinger lower_bound", time_ms([&]() {
+        for (const auto& probe : probes) {
+            checksum -= layout.lower_bound(probe);
+        }
+    }));
+    if (checksum != 0) {
+        std::cout << "  rank mismatch" << std::endl;
+    }
+}
+
+// Learned index vs bisection over the same sorted keys, for uniform keys and
+// for skewed ones (gaps drawn from a heavy-tailed distribution), at several
+// error bounds: build time, index size next to the keys, and lookup time.
+inline void bench_learned_index() {
+    const size_t n = size_t(1) << 24;
+    const size_t queries = 5000000;
+    std::cout << "Learned index: " << n << " sorted keys (" << (n * sizeof(uint64_t) >> 20) << " MiB), "
+              << queries << " lower_bound queries" << std::endl;
+
+    std::mt19937_64 rng(42);
+    for (int skewed = 0; skewed < 2; ++skewed) {
+        SimpelVector<uint64_t> sorted;
+        sorted.reserve(n);
+        if (skewed) {
+            std::lognormal_distribution<double> gap(0.0, 2.0);
+            uint64_t key = 0;
+            for (size_t i = 0; i < n; ++i) {
+                key += 1 + static_cast<uint64_t>(gap(rng));
+                sorted.push_back(key);
+            }
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                sorted.push_back(rng() >> 1);
+            }
+            std::sort(sorted.begin(), sorted.end());
+        }
+        const uint64_t span = sorted[n - 1];
+        SimpelVector<uint64_t> probes;
+        for (size_t i = 0; i < queries; ++i) {
+            probes.push_back(rng() % span);
+        }
+        std::cout << (skewed ? " skewed keys" : " uniform keys") << std::endl;
+
+        size_t expected = 0;
+        print_result("std::lower_bound", time_ms([&]() {
+            const uint64_t* first = sorted.data();
+            for (const auto& probe : probes) {
+                expected += static_cast<size_t>(std::lower_bound(first, first + n, probe) - first);
+            }
+        }));
+        for (size_t epsilon : { size_t(16), size_t(64), size_t(256) }) {
+            LearnedIndex<uint64_t> index;
+            const double build = time_ms([&]() {
+                LearnedIndex<uint64_t> built(sorted, epsilon);
+                index.swap(built);
+            });
+            size_t checksum = 0;
+            const double lookup = time_ms([&]() {
+                for (const auto& probe : probes) {
+                    checksum += index.lower_bound(probe);
+                }
+            });
+            std::cout << "  epsilon " << std::setw(3) << epsilon << ": " << std::setw(8) << index.segments()
+                      << " segments, " << index.levels() << " levels, " << std::setw(8) << index.bytes()
+                      << " bytes, build " << std::setprecision(2) << build << " ms" << std::endl;
+            print_result("LearnedIndex lower_bound", lookup);
+            if (checksum != expected) {
+                std::cout << "  rank mismatch" << std::endl;
+            }
+        }
+    }
+}
+
+// Prefix sums: the parallel SIMD scan against std::partial_sum over one
+// large vector, then mixed point updates and range sums on the Fenwick tree
+// and the segment tree.
+inline void bench_prefix_sums() {
+    const size_t n = size_t(1) << 25;
+    std::cout << "Prefix sums: " << n << " uint64 values" << std::endl;
+    std::mt19937_64 rng(42);
+    SimpelVector<uint64_t> values;
+    values.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        values.push_back(rng() & 0xFFFF);
+    }
+    SimpelVector<uint64_t> scanned;
+    scanned.resize(n);
+
+    print_result("std::partial_sum", time_ms([&]() {
+        std::partial_sum(values.data(), values.data() + n, scanned.data());
+    }));
+    const uint64_t expected = scanned[n - 1];
+    print_result("inclusive_scan", time_ms([&]() {
+        inclusive_scan(values, scanned);
+    }));
+    if (scanned[n - 1] != expected) {
+        std::cout << "  scan mismatch" << std::endl;
+    }
+    std::memcpy(scanned.data(), values.data(), n * sizeof(uint64_t));
+    print_result("exclusive_scan_in_place", time_ms([&]() {
+        exclusive_scan_in_place(scanned);
+    }));
+    if (scanned[n - 1] + values[n - 1] != expected) {
+        std::cout << "  scan mismatch" << std::endl;
+    }
+
+    const size_t counters = size_t(1) << 20;
+    const size_t operations = 4000000;
+    std::cout << "Range sums: " << counters << " counters, " << operations << " updates + range queries" << std::endl;
+    SimpelVector<uint64_t> initial;
+    for (size_t i = 0; i < counters; ++i) {
+        initial.push_back(i & 0xFF);
+    }
+    SimpelVector<uint64_t> positions;
+    for (size_t i = 0; i < 2 * operations; ++i) {
+        positions.push_back(rng() % counters);
+    }
+    uint64_t fenwick_total = 0;
+    print_result("FenwickTree", time_ms([&]() {
+        FenwickTree<uint64_t> tree(initial);
+        for (size_t i = 0; i < operations; ++i) {
+            tree.add(positions[2 * i], 1);
+            const size_t a = positions[2 * i + 1];
+            fenwick_total += tree.range_sum(a / 2, a);
+        }
+    }));
+    uint64_t segment_total = 0;
+    print_result("SegmentTree", time_ms([&]() {
+        SegmentTree<uint64_t> tree(initial);
+        for (size_t i = 0; i < operations; ++i) {
+            tree.apply(positions[2 * i], 1);
+            const size_t a = positions[2 * i + 1];
+            segment_total += tree.query(a / 2, a);
+        }
+    }));
+    if (fenwick_total != segment_total) {
+        std::cout << "  range sum mismatch" << std::endl;
+    }
+}
+
+// Aggregation: histogram() against a plain counting loop for few buckets
+// (long runs of equal keys), a cache-sized and a far larger bucket range,
+// then group_by_sum() over sparse 64-bit keys against std::unordered_map.
+inline void bench_aggregation() {
+    const size_t n = size_t(1) << 25;
+    std::cout << "Aggregation: " << n << " keys" << std::endl;
+    std::mt19937_64 rng(42);
+
+    for (size_t buckets : { size_t(16), size_t(1) << 16, size_t(1) << 24 }) {
+        SimpelVector<uint32_t> keys;
+        keys.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            // few buckets: runs of equal keys, the case that serializes a single table
+            keys.push_back(static_cast<uint32_t>(buckets == 16 ? (i >> 6) % 3 : rng() % buckets));
+        }
+        std::cout << " " << buckets << " buckets" << std::endl;
+        SimpelVector<uint64_t> plain;
+        print_result("counting loop", time_ms([&]() {
+            plain.resize(buckets);
+            for (const auto& key : keys) {
+                ++plain.data()[key];
+            }
+        }));
+        SimpelVector<uint64_t> counts;
+        print_result("histogram", time_ms([&]() {
+            SimpelVector<uint64_t> result = histogram(keys, buckets);
+            counts.swap(result);
+        }));
+        for (size_t bucket = 0; bucket < buckets; ++bucket) {
+            if (counts[bucket] != plain[bucket]) {
+                std::cout << "  count mismatch" << std::endl;
+                break;
+            }
+        }
+    }
+
+    const size_t rows = size_t(1) << 23;
+    std::cout << " group_by_sum: " << rows << " rows, ~" << rows / 4 << " distinct 64-bit keys" << std::endl;
+    SimpelVector<uint64_t> ids;
+    SimpelVector<uint64_t> amounts;
+    for (size_t i = 0; i < rows; ++i) {
+        ids.push_back((rng() % (rows / 4)) * 0x9E3779B1ull);
+        amounts.push_back(i & 0xFF);
+    }
+    size_t map_groups = 0;
+    print_result("std::unordered_map", time_ms([&]() {
+        std::unordered_map<uint64_t, uint64_t> sums;
+        for (size_t i = 0; i < rows; ++i) {
+            sums[ids[i]] += amounts[i];
+        }
+        map_groups = sums.size();
+    }));
+    size_t groups = 0;
+    print_result("group_by_sum (partitioned)", time_ms([&]() {
+        groups = group_by_sum(ids, amounts).keys.size();
+    }));
+    if (groups != map_groups) {
+        std::cout << "  group count mismatch" << std::endl;
+    }
+}
+
+// Foreign-key join: a build column of unique keys far larger than the cache,
+// joined with an 8x larger probe column, partitioned hash join against probing
+// one std::unordered_map; plus radix_partition on its own, in one and two passes.
+inline void bench_hash_join() {
+    const size_t build_rows = size_t(1) << 22;
+    const size_t probe_rows = size_t(1) << 25;
+    std::cout << "Hash join: " << build_rows << " build rows x " << probe_rows << " probe rows" << std::endl;
+    std::mt19937_64 rng(42);
+    SimpelVector<uint64_t> build_keys;
+    for (size_t i = 0; i < build_rows; ++i) {
+        build_keys.push_back(i * 0x9E3779B1ull);
+    }
+    std::shuffle(build_keys.begin(), build_keys.end(), rng);
+    SimpelVector<uint64_t> probe_keys;
+    for (size_t i = 0; i < probe_rows; ++i) {
+        probe_keys.push_back((rng() % (build_rows + build_rows / 4)) * 0x9E3779B1ull); // 20% without a match
+    }
+
+    size_t map_matches = 0;
+    print_result("std::unordered_map join", time_ms([&]() {
+        std::unordered_map<uint64_t, uint32_t> table;
+        table.reserve(build_rows);
+        for (size_t i = 0; i < build_rows; ++i) {
+            table.emplace(build_keys[i], static_cast<uint32_t>(i));
+        }
+        JoinPairs pairs;
+        for (size_t j = 0; j < probe_rows; ++j) {
+            const auto match = table.find(probe_keys[j]);
+            if (match != table.end()) {
+                pairs.build_rows.push_back(match->second);
+                pairs.probe_rows.push_back(static_cast<uint32_t>(j));
+            }
+        }
+        map_matches = pairs.build_rows.size();
+    }));
+    size_t matches = 0;
+    print_result("hash_join (radix partitioned)", time_ms([&]() {
+        matches = hash_join(build_keys, probe_keys).build_rows.size();
+    }));
+    if (matches != map_matches) {
+        std::cout << "  match count mismatch" << std::endl;
+    }
+
+    SimpelVector<uint32_t> rows;
+    rows.resize(probe_rows);
+    print_result("radix_partition 10 bits (1 pass)", time_ms([&]() {
+        const RadixPartitions<uint64_t, uint32_t> parts = radix_partition(probe_keys, rows, 10);
+        matches = parts.partition_count();
+    }));
+    print_result("radix_partition 16 bits (2 passes)", time_ms([&]() {
+        const RadixPartitions<uint64_t, uint32_t> parts = radix_partition(probe_keys, rows, 16);
+        matches = parts.partition_count();
+    }));
+}
+
+// Streaming copies: a 256 MiB SimpelVector copy (append into reserved
+// storage) with ordinary and with streaming stores, and what each does to a
+// workload that keeps an 8 MiB working set in the last-level cache: timed
+// while a second thread copies concurrently (with one core they take turns in
+// time slices), and timed right after a copy on the same thread, which shows
+// the eviction alone.
+inline void bench_streaming_copy() {
+    const size_t n = size_t(32) << 20;
+    const size_t table_size = size_t(1) << 20;
+    const size_t victim_reads = size_t(1) << 24;
+    const size_t short_reads = size_t(1) << 20;
+    std::cout << "Streaming copy: " << (n * sizeof(uint64_t) >> 20) << " MiB copies, victim re-reading "
+              << (table_size * sizeof(uint64_t) >> 20) << " MiB" << std::endl;
+
+    SimpelVector<uint64_t> source;
+    source.resize(n, 1);
+    SimpelVector<uint64_t> copy;
+    copy.reserve(n);
+    SimpelVector<uint64_t> table;
+    for (size_t i = 0; i < table_size; ++i) {
+        table.push_back(i);
+    }
+    SimpelVector<uint32_t> probes;
+    std::mt19937_64 rng(42);
+    for (size_t i = 0; i < victim_reads; ++i) {
+        probes.push_back(static_cast<uint32_t>(rng() % table_size));
+    }
+    uint64_t checksum = 0;
+    const auto victim = [&](size_t reads) {
+        for (size_t i = 0; i < reads; ++i) {
+            checksum += table.data()[probes.data()[i]];
+        }
+    };
+    const auto copy_once = [&]() {
+        copy.clear();
+        copy.append(source.data(), n);
+    };
+
+    const size_t saved_threshold = streaming_threshold();
+    const size_t rounds = 8;
+    victim(victim_reads);
+    print_result("victim alone", time_ms([&]() { victim(victim_reads); }));
+    print_result("victim pass, warm cache", time_ms([&]() {
+        for (size_t r = 0; r < rounds; ++r) {
+            victim(short_reads);
+        }
+    }) / rounds);
+    for (int streaming = 0; streaming < 2; ++streaming) {
+        set_streaming_threshold(streaming ? kDefaultStreamingThreshold : SIZE_MAX);
+        const std::string mode = streaming ? "streaming" : "ordinary";
+        print_result((mode + " copy alone").c_str(), time_ms(copy_once));
+
+        double after_copy = 0;
+        for (size_t r = 0; r < rounds; ++r) {
+            copy_once();
+            after_copy += time_ms([&]() { victim(short_reads); });
+        }
+        print_result(("victim pass after " + mode + " copy").c_str(), after_copy / rounds);
+
+        std::atomic<bool> done(false);
+        std::thread copier([&]() {
+            while (!done.load()) {
+                copy_once();
+            }
+        });
+        const double beside = time_ms([&]() { victim(victim_reads); });
+        done = true;
+        copier.join();
+        print_result(("victim beside " + mode + " copies").c_str(), beside);
+    }
+    set_streaming_threshold(saved_threshold);
+    if (checksum == 0 || copy[n - 1] != 1) {
+        std::cout << "  copy mismatch" << std::endl;
+    }
+}
+
+inline void run_benchmarks() {
+    bench_slab_allocator();
+    bench_nd_layouts();
+    bench_gap_buffer();
+    bench_heaps();
+    bench_ordered_index();
+    bench_eytzinger();
+    bench_learned_index();
+    bench_prefix_sums();
+    bench_aggregation();
+    bench_hash_join();
+    bench_streaming_copy();
+}
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "SimpelVector.h"
+#include "Platform.h"
+
+// Length of the common prefix of a and b, comparing 16 bytes per step with SSE2.
+inline size_t common_prefix(std::string_view a, std::string_view b) {
+    const size_t n = a.size() < b.size() ? a.size() : b.size();
+    size_t i = 0;
+#if defined(SIMPEL_HAS_SSE2)
+    for (; i + 16 <= n; i += 16) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.data() + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b.data() + i));
+        const unsigned equal = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+        if (equal != 0xFFFF) {
+            return i + static_cast<size_t>(std::countr_zero(~equal));
+        }
+    }
+#endif
+    while (i < n && a[i] == b[i]) {
+        ++i;
+    }
+    return i;
+}
+
+// Three-way byte-wise comparison (like memcmp, shorter prefix first) built on common_prefix.
+inline int compare_bytes(std::string_view a, std::string_view b) {
+    const size_t prefix = common_prefix(a, b);
+    if (prefix < a.size() && prefix < b.size()) {
+        return static_cast<unsigned char>(a[prefix]) < static_cast<unsigned char>(b[prefix]) ? -1 : 1;
+    }
+    return a.size() == b.size() ? 0 : (a.size() < b.size() ? -1 : 1);
+}
+
+// Vector of byte strings stored back to back in one growable buffer.
+// Element i is bytes [offsets[i], offsets[i + 1]), so n strings cost one
+// Offset each instead of a std::string header plus a heap block each.
+// Elements are read as std::string_view; views are invalidated by anything
+// that grows the byte buffer, like SimpelVector iterators.
+//
+// Offset is uint64_t by default; uint32_t halves the index overhead and limits
+// the total payload to 4 GiB (exceeding it throws std::length_error).
+template <typename Offset = uint64_t>
+class BasicBlobVector {
+    static_assert(std::is_unsigned_v<Offset>, "Offset must be an unsigned integer");
+
+private:
+    SimpelVector<char> m_Bytes;     // all strings, back to back
+    SimpelVector<Offset> m_Offsets; // size() + 1 entries, m_Offsets[0] == 0
+
+    void check_total(size_t total_bytes) const {
+        if (total_bytes > static_cast<size_t>(std::numeric_limits<Offset>::max())) {
+            throw std::length_error("BlobVector payload exceeds the offset type");
+        }
+    }
+
+    std::string_view view(size_t index) const {
+        const Offset begin = m_Offsets.data()[index];
+        const Offset end = m_Offsets.data()[index + 1];
+        return std::string_view(m_Bytes.data() + begin, end - begin);
+    }
+
+    // first 8 bytes as a big-endian integer (zero padded): comparing keys orders like the bytes
+    static uint64_t prefix_key(std::string_view s) {
+        uint64_t key = 0;
+        const size_t n = s.size() < 8 ? s.size() : 8;
+        for (size_t i = 0; i < n; ++i) {
+            key |= static_cast<uint64_t>(static_cast<unsigned char>(s[i])) << (56 - 8 * i);
+        }
+        return key;
+    }
+
+    // make room for 'count' strings and 'bytes' payload bytes, at least doubling
+    // whatever has to grow so that repeated bulk appends stay amortized O(1)
+    void grow(size_t count, size_t bytes) {
+        if (count + 1 > m_Offsets.capacity()) {
+            m_Offsets.reserve(count + 1 > 2 * m_Offsets.capacity() ? count + 1 : 2 * m_Offsets.capacity());
+        }
+        if (bytes > m_Bytes.capacity()) {
+            m_Bytes.reserve(bytes > 2 * m_Bytes.capacity() ? bytes : 2 * m_Bytes.capacity());
+        }
+    }
+
+public:
+    BasicBlobVector() { m_Offsets.push_back(0); }
+
+    // Random-access iterator yielding string_views
+    class ConstIterator {
+    private:
+        const BasicBlobVector* m_Vector;
+        size_t m_Index;
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::string_view;
+
+        ConstIterator() : m_Vector(nullptr), m_Index(0) {}
+        ConstIterator(const BasicBlobVector* vector, size_t index) : m_Vector(vector), m_Index(index) {}
+        std::string_view operator*() const { return m_Vector->view(m_Index); }
+        std::string_view operator[](difference_type n) const { return m_Vector->view(m_Index + n); }
+        ConstIterator& operator++() { ++m_Index; return *this; }
+        ConstIterator operator++(int) { ConstIterator tmp = *this; ++m_Index; return tmp; }
+        ConstIterator& operator--() { --m_Index; return *this; }
+        ConstIterator operator--(int) { ConstIterator tmp = *this; --m_Index; return tmp; }
+        ConstIterator& operator+=(difference_type n) { m_Index += n; return *this; }
+        ConstIterator& operator-=(difference_type n) { m_Index -= n; return *this; }
+        ConstIterator operator+(difference_type n) const { return ConstIterator(m_Vector, m_Index + n); }
+        ConstIterator operator-(difference_type n) const { return ConstIterator(m_Vector, m_Index - n); }
+        difference_type operator-(const ConstIterator& other) const {
+            return static_cast<difference_type>(m_Index) - static_cast<difference_type>(other.m_Index);
+        }
+        bool operator==(const ConstIterator& other) const { return m_Index == other.m_Index; }
+        bool operator!=(const ConstIterator& other) const { return m_Index != other.m_Index; }
+        bool operator<(const ConstIterator& other) const { return m_Index < other.m_Index; }
+        bool operator>(const ConstIterator& other) const { return m_Index > other.m_Index; }
+        bool operator<=(const ConstIterator& other) const { return m_Index <= other.m_Index; }
+        bool operator>=(const ConstIterator& other) const { return m_Index >= other.m_Index; }
+    };
+
+    // Index operator: checks bounds and returns a view of the element
+    std::string_view operator[](size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return view(index);
+    }
+
+    // 'value' may be a view of one of this vector's own elements
+    void push_back(std::string_view value) {
+        check_total(m_Bytes.size() + value.size());
+        const std::less<const char*> before;
+        const char* bytes = m_Bytes.data();
+        if (!value.empty() && bytes && !before(value.data(), bytes) && before(value.data(), bytes + m_Bytes.size())) {
+            // growing would free the viewed bytes: grow first, then copy by offset
+            const size_t offset = static_cast<size_t>(value.data() - bytes);
+            grow(size() + 1, m_Bytes.size() + value.size());
+            m_Bytes.append(m_Bytes.data() + offset, value.size());
+        } else {
+            m_Bytes.append(value.data(), value.size());
+        }
+        m_Offsets.push_back(static_cast<Offset>(m_Bytes.size()));
+    }
+
+    // Bulk append: sizes everything first, so both buffers grow at most once.
+    // The strings must not be views of this vector's elements (growing frees them);
+    // this vector's own iterators are fine, they hand out fresh views.
+    template <typename It>
+    void append(It first, It last) {
+        size_t count = 0;
+        size_t total = m_Bytes.size();
+        for (It it = first; it != last; ++it) {
+            total += std::string_view(*it).size();
+            ++count;
+        }
+        check_total(total);
+        grow(size() + count, total);
+        for (It it = first; it != last; ++it) {
+            const std::string_view value(*it);
+            m_Bytes.append(value.data(), value.size());
+            m_Offsets.push_back(static_cast<Offset>(m_Bytes.size()));
+        }
+    }
+
+    // Bulk append of 'count' strings packed back to back in 'bytes' (e.g. tokenizer
+    // output), with lengths[i] the length of string i. 'bytes' must not point
+    // into this vector.
+    template <typename Length>
+    void append_packed(const char* bytes, const Length* lengths, size_t count) {
+        size_t payload = 0;
+        for (size_t i = 0; i < count; ++i) {
+            payload += static_cast<size_t>(lengths[i]);
+        }
+        check_total(m_Bytes.size() + payload);
+        grow(size() + count, m_Bytes.size() + payload);
+        m_Bytes.append(bytes, payload);
+        Offset offset = m_Offsets.data()[size()];
+        for (size_t i = 0; i < count; ++i) {
+            offset += static_cast<Offset>(lengths[i]);
+            m_Offsets.push_back(offset);
+        }
+    }
+
+    void pop_back() {
+        if (empty()) {
+            throw std::out_of_range("Vector is empty");
+        }
+        m_Offsets.pop_back();
+        m_Bytes.resize(m_Offsets.data()[size()]);
+    }
+
+    // reserve room for 'count' strings and 'bytes' bytes of payload in total
+    void reserve(size_t count, size_t bytes) {
+        m_Offsets.reserve(count + 1);
+        m_Bytes.reserve(bytes);
+    }
+
+    void clear() {
+        m_Bytes.clear();
+        m_Offsets.clear();
+        m_Offsets.push_back(0);
+    }
+
+    // accessors
+    size_t size() const { return m_Offsets.size() - 1; }
+    bool empty() const { return size() == 0; }
+    size_t bytes() const { return m_Bytes.size(); }
+    const char* data() const { return m_Bytes.data(); }
+    const Offset* offsets() const { return m_Offsets.data(); }
+
+    ConstIterator begin() const { return ConstIterator(this, 0); }
+    ConstIterator end() const { return ConstIterator(this, size()); }
+
+    // Permutation that sorts the strings byte-wise: element perm[0] is the smallest.
+    // Comparisons first use an 8-byte big-endian prefix key held next to the
+    // index, so most of them never touch the byte buffer; ties fall back to
+    // the SIMD prefix compare of the remaining bytes. The sort is stable.
+    SimpelVector<uint32_t> sort_permutation() const {
+        if (size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("Too many strings for a 32-bit permutation");
+        }
+        struct Entry {
+            uint64_t key;
+            uint32_t index;
+        };
+        SimpelVector<Entry> entries;
+        entries.reserve(size());
+        for (size_t i = 0; i < size(); ++i) {
+            entries.push_back(Entry{ prefix_key(view(i)), static_cast<uint32_t>(i) });
+        }
+        std::stable_sort(entries.begin(), entries.end(), [this](const Entry& a, const Entry& b) {
+            if (a.key != b.key) {
+                return a.key < b.key;
+            }
+            return compare_bytes(view(a.index), view(b.index)) < 0;
+        });
+
+        SimpelVector<uint32_t> perm;
+        perm.reserve(size());
+        for (const auto& entry : entries) {
+            perm.push_back(entry.index);
+        }
+        return perm;
+    }
+
+    // Rebuild the vector in permutation order: element i becomes old element perm[i].
+    // perm must name every element exactly once; otherwise the vector is left
+    // unchanged and std::out_of_range / std::invalid_argument is thrown.
+    void apply_permutation(const SimpelVector<uint32_t>& perm) {
+        if (perm.size() != size()) {
+            throw std::invalid_argument("Permutation size does not match vector size");
+        }
+        SimpelVector<uint8_t> seen;
+        seen.resize(size(), 0);
+        size_t total = 0;
+        for (const auto& index : perm) {
+            if (index >= size()) {
+                throw std::out_of_range("Index out of range");
+            }
+            if (seen.data()[index]) {
+                throw std::invalid_argument("Permutation repeats an index");
+            }
+            seen.data()[index] = 1;
+            total += m_Offsets.data()[index + 1] - m_Offsets.data()[index];
+        }
+        check_total(total);
+
+        BasicBlobVector sorted;
+        sorted.reserve(size(), total);
+        for (const auto& index : perm) {
+            const std::string_view value = view(index);
+            sorted.m_Bytes.append(value.data(), value.size());
+            sorted.m_Offsets.push_back(static_cast<Offset>(sorted.m_Bytes.size()));
+        }
+        swap(sorted);
+    }
+
+    void sort() { apply_permutation(sort_permutation()); }
+
+    void swap(BasicBlobVector& other) noexcept {
+        m_Bytes.swap(other.m_Bytes);
+        m_Offsets.swap(other.m_Offsets);
+    }
+};
+
+using BlobVector = BasicBlobVector<uint64_t>;
+using BlobVector32 = BasicBlobVector<uint32_t>;
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#include "SimpelVector.h"
+
+// Turn a SimpelVector built at compile time into a static std::array.
+// Heap memory allocated during constant evaluation must be freed before it ends,
+// so the vector itself cannot be a constexpr variable; its contents can.
+// 'Build' is a constexpr function (or captureless lambda) returning a SimpelVector.
+// It is evaluated twice: once to learn the size, once to copy the elements.
+//
+//   constexpr SimpelVector<int> make_squares() { ... }
+//   constexpr auto kSquares = to_static_array<make_squares>(); // std::array<int, N>
+template <auto Build>
+consteval auto to_static_array() {
+    using Vector = std::remove_cvref_t<decltype(Build())>;
+    using T = typename Vector::value_type;
+    constexpr size_t N = Build().size();
+
+    std::array<T, N> table{};
+    const Vector vec = Build();
+    for (size_t i = 0; i < N; ++i) {
+        table[i] = vec[i];
+    }
+    return table;
+}
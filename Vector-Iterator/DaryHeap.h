@@ -0,0 +1,446 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "SimpelVector.h"
+
+// d-ary heap on SimpelVector storage, a drop-in for std::priority_queue:
+// top() is the largest element under Compare (use std::greater for a min-heap).
+// Node i has children D*i+1 .. D*i+D. With D = 4 or 8 the tree is 2-3x
+// shallower than a binary heap and the D children of a node share one or two
+// cache lines, so pop() takes fewer (and cheaper) cache misses; push() gets
+// cheaper too since it only walks up the shorter tree.
+template <typename T, size_t D = 4, typename Compare = std::less<T>>
+class DaryHeap {
+    static_assert(D >= 2, "A heap needs at least two children per node");
+
+private:
+    SimpelVector<T> m_Data;
+    Compare m_Compare;
+
+    // move the element at 'index' up to its place (hole technique: one move per level)
+    void sift_up(size_t index) {
+        T* data = m_Data.data();
+        T value = std::move(data[index]);
+        while (index > 0) {
+            const size_t parent = (index - 1) / D;
+            if (!m_Compare(data[parent], value)) {
+                break;
+            }
+            data[index] = std::move(data[parent]);
+            index = parent;
+        }
+        data[index] = std::move(value);
+    }
+
+    // move the element at 'index' down to its place within the first 'size' elements
+    void sift_down(size_t index, size_t size) {
+        T* data = m_Data.data();
+        T value = std::move(data[index]);
+        for (;;) {
+            const size_t first = D * index + 1;
+            if (first >= size) {
+                break;
+            }
+            const size_t last = first + D < size ? first + D : size;
+            size_t best = first;
+            for (size_t child = first + 1; child < last; ++child) {
+                if (m_Compare(data[best], data[child])) {
+                    best = child;
+                }
+            }
+            if (!m_Compare(value, data[best])) {
+                break;
+            }
+            data[index] = std::move(data[best]);
+            index = best;
+        }
+        data[index] = std::move(value);
+    }
+
+    // Floyd's bottom-up heap construction: sift down every inner node, O(n)
+    void heapify() {
+        const size_t n = m_Data.size();
+        if (n < 2) {
+            return;
+        }
+        for (size_t index = (n - 2) / D + 1; index-- > 0;) {
+            sift_down(index, n);
+        }
+    }
+
+public:
+    explicit DaryHeap(const Compare& compare = Compare()) : m_Compare(compare) {}
+
+    // build from existing values in O(n)
+    explicit DaryHeap(SimpelVector<T>&& values, const Compare& compare = Compare()) : m_Compare(compare) {
+        m_Data.swap(values);
+        heapify();
+    }
+
+    void push(const T& value) {
+        m_Data.push_back(value);
+        sift_up(m_Data.size() - 1);
+    }
+
+    void push(T&& value) {
+        m_Data.push_back(std::move(value));
+        sift_up(m_Data.size() - 1);
+    }
+
+    // Add 'count' values at once. Small batches are sifted up one by one
+    // (O(count log n)); once that would cost more than rebuilding, the values
+    // are appended and the whole heap is rebuilt with Floyd's heapify (O(n)).
+    void push_bulk(const T* values, size_t count) {
+        const size_t old_size = m_Data.size();
+        m_Data.append(values, count);
+        const size_t n = m_Data.size();
+        size_t depth = 1;
+        for (size_t level = D; level < n; level *= D) {
+            ++depth;
+        }
+        if (count * depth < n) {
+            for (size_t index = old_size; index < n; ++index) {
+                sift_up(index);
+            }
+        } else {
+            heapify();
+        }
+    }
+
+    const T& top() const {
+        if (empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+        return m_Data.data()[0];
+    }
+
+    void pop() {
+        if (empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+        // Bottom-up pop: walk the hole at the root down to a leaf along the best
+        // children (no compare against the moved element), then sift the last
+        // element up from there. It rarely climbs far, so this saves about one
+        // compare per level over a plain sift-down.
+        T* data = m_Data.data();
+        const size_t last = m_Data.size() - 1;
+        size_t hole = 0;
+        for (;;) {
+            const size_t first = D * hole + 1;
+            if (first >= last) {
+                break;
+            }
+            const size_t end = first + D < last ? first + D : last;
+            size_t best = first;
+            for (size_t child = first + 1; child < end; ++child) {
+                best = m_Compare(data[best], data[child]) ? child : best; // cmov, random keys defeat the predictor
+            }
+            data[hole] = std::move(data[best]);
+            hole = best;
+        }
+        if (hole != last) {
+            data[hole] = std::move(data[last]);
+            sift_up(hole);
+        }
+        m_Data.pop_back();
+    }
+
+    // pop the top 'count' elements (fewer if the heap runs out) into 'out', best first
+    void pop_n(size_t count, SimpelVector<T>& out) {
+        count = count < size() ? count : size();
+        out.reserve(out.size() + count);
+        for (size_t i = 0; i < count; ++i) {
+            out.push_back(std::move(m_Data.data()[0]));
+            pop();
+        }
+    }
+
+    void reserve(size_t count) { m_Data.reserve(count); }
+    void clear() { m_Data.clear(); }
+
+    // accessors
+    size_t size() const { return m_Data.size(); }
+    bool empty() const { return m_Data.empty(); }
+};
+
+// d-ary heap of (id, key) entries with a position index, so the key of an
+// element that is already queued can be changed in O(log n) (decrease_key in
+// Dijkstra, re-arming a timer). Ids are dense integers below 'id_limit'.
+// top is the best key under Compare; the default std::greater makes it the
+// smallest key, where decrease_key moves an element towards the top.
+template <typename Key, size_t D = 4, typename Compare = std::greater<Key>>
+class IndexedDaryHeap {
+    static_assert(D >= 2, "A heap needs at least two children per node");
+
+private:
+    static constexpr uint32_t kAbsent = 0xFFFFFFFF;
+
+    struct Entry {
+        Key key;
+        uint32_t id;
+    };
+
+    SimpelVector<Entry> m_Data;
+    SimpelVector<uint32_t> m_Position; // heap index of every id, kAbsent if not queued
+    Compare m_Compare;
+
+    void check_id(size_t id) const {
+        if (id >= m_Position.size()) {
+            throw std::out_of_range("Id out of range");
+        }
+    }
+
+    void sift_up(size_t index) {
+        Entry* data = m_Data.data();
+        uint32_t* position = m_Position.data();
+        Entry entry = std::move(data[index]);
+        while (index > 0) {
+            const size_t parent = (index - 1) / D;
+            if (!m_Compare(data[parent].key, entry.key)) {
+                break;
+            }
+            data[index] = std::move(data[parent]);
+            position[data[index].id] = static_cast<uint32_t>(index);
+            index = parent;
+        }
+        position[entry.id] = static_cast<uint32_t>(index);
+        data[index] = std::move(entry);
+    }
+
+    void sift_down(size_t index) {
+        Entry* data = m_Data.data();
+        uint32_t* position = m_Position.data();
+        const size_t size = m_Data.size();
+        Entry entry = std::move(data[index]);
+        for (;;) {
+            const size_t first = D * index + 1;
+            if (first >= size) {
+                break;
+            }
+            const size_t last = first + D < size ? first + D : size;
+            size_t best = first;
+            for (size_t child = first + 1; child < last; ++child) {
+                if (m_Compare(data[best].key, data[child].key)) {
+                    best = child;
+                }
+            }
+            if (!m_Compare(entry.key, data[best].key)) {
+                break;
+            }
+            data[index] = std::move(data[best]);
+            position[data[index].id] = static_cast<uint32_t>(index);
+            index = best;
+        }
+        position[entry.id] = static_cast<uint32_t>(index);
+        data[index] = std::move(entry);
+    }
+
+    // remove the entry at heap index 'index'
+    void remove_at(size_t index) {
+        Entry* data = m_Data.data();
+        m_Position.data()[data[index].id] = kAbsent;
+        const size_t last = m_Data.size() - 1;
+        if (index != last) {
+            data[index] = std::move(data[last]);
+            m_Position.data()[data[index].id] = static_cast<uint32_t>(index);
+        }
+        m_Data.pop_back();
+        if (index < m_Data.size()) {
+            // the moved entry may belong above or below 'index'
+            const uint32_t moved = data[index].id;
+            sift_up(index);
+            sift_down(m_Position.data()[moved]);
+        }
+    }
+
+public:
+    explicit IndexedDaryHeap(size_t id_limit, const Compare& compare = Compare()) : m_Compare(compare) {
+        if (id_limit >= kAbsent) {
+            throw std::length_error("Too many ids for a 32-bit position index");
+        }
+        m_Position.resize(id_limit, kAbsent);
+    }
+
+    // queue 'id' with 'key'; throws if it is already queued
+    void push(size_t id, const Key& key) {
+        check_id(id);
+        if (m_Position.data()[id] != kAbsent) {
+            throw std::invalid_argument("Id is already in the heap");
+        }
+        m_Data.push_back(Entry{ key, static_cast<uint32_t>(id) });
+        sift_up(m_Data.size() - 1);
+    }
+
+    // Improve the key of a queued id; the new key must not be worse under Compare.
+    void decrease_key(size_t id, const Key& key) {
+        check_id(id);
+        const uint32_t index = m_Position.data()[id];
+        if (index == kAbsent) {
+            throw std::invalid_argument("Id is not in the heap");
+        }
+        if (m_Compare(key, m_Data.data()[index].key)) {
+            throw std::invalid_argument("decrease_key would make the key worse");
+        }
+        m_Data.data()[index].key = key;
+        sift_up(index);
+    }
+
+    // set the key of 'id' in either direction, queueing it if it is absent
+    void update(size_t id, const Key& key) {
+        check_id(id);
+        const uint32_t index = m_Position.data()[id];
+        if (index == kAbsent) {
+            push(id, key);
+            return;
+        }
+        const bool better = !m_Compare(key, m_Data.data()[index].key);
+        m_Data.data()[index].key = key;
+        if (better) {
+            sift_up(index);
+        } else {
+            sift_down(index);
+        }
+    }
+
+    // remove 'id' if it is queued; returns whether it was
+    bool erase(size_t id) {
+        check_id(id);
+        const uint32_t index = m_Position.data()[id];
+        if (index == kAbsent) {
+            return false;
+        }
+        remove_at(index);
+        return true;
+    }
+
+    bool contains(size_t id) const {
+        check_id(id);
+        return m_Position.data()[id] != kAbsent;
+    }
+
+    const Key& key_of(size_t id) const {
+        check_id(id);
+        const uint32_t index = m_Position.data()[id];
+        if (index == kAbsent) {
+            throw std::invalid_argument("Id is not in the heap");
+        }
+        return m_Data.data()[index].key;
+    }
+
+    size_t top_id() const {
+        if (empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+        return m_Data.data()[0].id;
+    }
+
+    const Key& top_key() const {
+        if (empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+        return m_Data.data()[0].key;
+    }
+
+    void pop() {
+        if (empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+        remove_at(0);
+    }
+
+    // accessors
+    size_t size() const { return m_Data.size(); }
+    bool empty() const { return m_Data.empty(); }
+};
+
+// Radix heap for monotone unsigned integer keys (event times, Dijkstra distances):
+// every pushed key must be >= the last popped key. An entry goes into bucket
+// bit_width(key ^ last), i.e. by the highest bit in which it differs from the
+// last popped key. Popping empties bucket 0 first; otherwise the lowest
+// non-empty bucket is redistributed around its minimum, and every entry moves
+// to a strictly lower bucket, so each entry is touched at most bits+1 times.
+template <typename T, typename Key = uint64_t>
+class RadixHeap {
+    static_assert(std::is_unsigned_v<Key>, "RadixHeap needs an unsigned key");
+
+private:
+    static constexpr size_t kBuckets = std::numeric_limits<Key>::digits + 1;
+
+    struct Entry {
+        Key key;
+        T value;
+    };
+
+    SimpelVector<Entry> m_Buckets[kBuckets];
+    Key m_Last;
+    size_t m_Size;
+
+    size_t bucket_of(Key key) const { return static_cast<size_t>(std::bit_width(static_cast<Key>(key ^ m_Last))); }
+
+    // make sure bucket 0 holds the minimum (all entries there have key == m_Last)
+    void refill() {
+        if (!m_Buckets[0].empty()) {
+            return;
+        }
+        size_t bucket = 1;
+        while (m_Buckets[bucket].empty()) {
+            ++bucket;
+        }
+        SimpelVector<Entry>& source = m_Buckets[bucket];
+        Key minimum = source.data()[0].key;
+        for (size_t i = 1; i < source.size(); ++i) {
+            minimum = source.data()[i].key < minimum ? source.data()[i].key : minimum;
+        }
+        m_Last = minimum;
+        for (size_t i = 0; i < source.size(); ++i) {
+            m_Buckets[bucket_of(source.data()[i].key)].push_back(std::move(source.data()[i]));
+        }
+        source.clear();
+    }
+
+public:
+    RadixHeap() : m_Last(0), m_Size(0) {}
+
+    void push(Key key, const T& value) {
+        if (key < m_Last) {
+            throw std::invalid_argument("RadixHeap keys must not be smaller than the last popped key");
+        }
+        m_Buckets[bucket_of(key)].push_back(Entry{ key, value });
+        ++m_Size;
+    }
+
+    // smallest key (redistributes buckets, hence not const)
+    Key top_key() {
+        if (empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+        refill();
+        return m_Last;
+    }
+
+    // remove and return an entry with the smallest key
+    std::pair<Key, T> pop() {
+        if (empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+        refill();
+        SimpelVector<Entry>& bucket = m_Buckets[0];
+        std::pair<Key, T> result(bucket.data()[bucket.size() - 1].key, std::move(bucket.data()[bucket.size() - 1].value));
+        bucket.pop_back();
+        --m_Size;
+        return result;
+    }
+
+    // accessors
+    size_t size() const { return m_Size; }
+    bool empty() const { return m_Size == 0; }
+    Key last_key() const { return m_Last; } // lower bound for the next push
+};
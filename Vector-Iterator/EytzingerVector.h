@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "SimpelVector.h"
+#include "Parallel.h"
+#include "Platform.h"
+
+// Read-only search structure over a sorted SimpelVector in Eytzinger (BFS)
+// order: node k (1-based) has children 2k and 2k+1, so the first levels of
+// every search share the same few cache lines, and the 16 possible nodes four
+// levels below k are contiguous (16k .. 16k+15). lower_bound() walks down
+// without branches (k = 2k + (key < x)) and prefetches those 16 nodes each
+// step, so the memory latency of deep levels overlaps with the search.
+// The array is offset so that each group of 16 starts on a cache line.
+//
+// Ranks[k] keeps the position of node k in the sorted input, so results are
+// reported as ranks, like std::lower_bound on the original vector. Rank is
+// uint32_t by default (inputs of up to 4G elements); use uint64_t beyond that.
+template <typename T, typename Rank = uint32_t>
+class EytzingerVector {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    static constexpr size_t kLine = 64;
+    static constexpr size_t kAlignSlack = kLine / sizeof(T) > 0 ? kLine / sizeof(T) : 1;
+
+    SimpelVector<T> m_Storage;  // n + 1 nodes (slot 0 unused) plus alignment slack
+    SimpelVector<Rank> m_Ranks; // sorted position of each node, slot 0 unused
+    size_t m_Offset;            // nodes start at m_Storage.data() + m_Offset
+    size_t m_Size;
+
+    const T* nodes() const { return m_Storage.data() + m_Offset; }
+
+    // number of nodes in the subtree of node k
+    size_t subtree_size(size_t k) const {
+        size_t size = 0;
+        for (size_t width = 1; k <= m_Size; k <<= 1, width <<= 1) {
+            const size_t level = m_Size - k + 1;
+            size += level < width ? level : width;
+        }
+        return size;
+    }
+
+    // sorted position of node k: its left subtree, plus every ancestor it is right of
+    size_t in_order_rank(size_t k) const {
+        size_t rank = subtree_size(2 * k);
+        for (; k > 1; k >>= 1) {
+            if (k & 1) {
+                rank += subtree_size(k - 1) + 1;
+            }
+        }
+        return rank;
+    }
+
+    // write the subtree of node k in order, taking values from sorted[rank...]
+    void fill(T* tree, const T* sorted, size_t k, size_t& rank) {
+        if (k > m_Size) {
+            return;
+        }
+        fill(tree, sorted, 2 * k, rank);
+        tree[k] = sorted[rank];
+        m_Ranks.data()[k] = static_cast<Rank>(rank);
+        ++rank;
+        fill(tree, sorted, 2 * k + 1, rank);
+    }
+
+    // node of the first element >= x, 0 if there is none
+    size_t descend(const T& x) const {
+        const T* tree = nodes();
+        size_t k = 1;
+        while (k <= m_Size) {
+            SIMPEL_PREFETCH(tree + 16 * k);
+            if constexpr (16 * sizeof(T) > kLine) {
+                SIMPEL_PREFETCH(tree + 16 * k + kLine / sizeof(T));
+            }
+            k = 2 * k + (tree[k] < x);
+        }
+        // undo the trailing right turns (1 bits) and the last left turn
+        return k >> (std::countr_one(k) + 1);
+    }
+
+public:
+    EytzingerVector() : m_Offset(0), m_Size(0) {}
+
+    // Build from a sorted (non-decreasing) vector. The subtrees below a fixed
+    // depth are independent in-order fills whose starting rank is computed
+    // directly, so they are built in parallel on the pool.
+    explicit EytzingerVector(const SimpelVector<T>& sorted) : m_Offset(0), m_Size(sorted.size()) {
+        if (sorted.size() >= static_cast<size_t>(std::numeric_limits<Rank>::max())) {
+            throw std::length_error("Too many elements for the rank type");
+        }
+        if (!std::is_sorted(sorted.cbegin(), sorted.cend())) {
+            throw std::invalid_argument("EytzingerVector needs sorted input");
+        }
+        m_Storage.resize(m_Size + 1 + kAlignSlack);
+        m_Ranks.resize(m_Size + 1);
+        // nodes[16k] on a cache-line boundary <=> nodes itself is line aligned
+        const uintptr_t address = reinterpret_cast<uintptr_t>(m_Storage.data());
+        if (kLine % sizeof(T) == 0 && address % sizeof(T) == 0) {
+            m_Offset = ((kLine - address % kLine) % kLine) / sizeof(T);
+        }
+        if (m_Size == 0) {
+            return;
+        }
+
+        T* tree = m_Storage.data() + m_Offset;
+        const T* values = sorted.data();
+
+        // nodes above 'depth' are placed one by one, the subtrees at 'depth' in parallel
+        size_t depth = 0;
+        const size_t tasks = parallel_chunk_count(m_Size) * 4;
+        while ((size_t(1) << depth) < tasks && (size_t(2) << depth) <= m_Size) {
+            ++depth;
+        }
+        const size_t first_root = size_t(1) << depth;
+        for (size_t k = 1; k < first_root; ++k) {
+            const size_t rank = in_order_rank(k);
+            tree[k] = values[rank];
+            m_Ranks.data()[k] = static_cast<Rank>(rank);
+        }
+        const size_t roots = (m_Size < 2 * first_root - 1 ? m_Size : 2 * first_root - 1) - first_root + 1;
+        parallel_for(roots, [&](size_t begin, size_t end) {
+            for (size_t root = first_root + begin; root < first_root + end; ++root) {
+                size_t rank = in_order_rank(root) - subtree_size(2 * root);
+                fill(tree, values, root, rank);
+            }
+        }, 1);
+    }
+
+    // Rank of the first element >= x in the sorted input (size() if there is none).
+    size_t lower_bound(const T& x) const {
+        const size_t k = descend(x);
+        return k == 0 ? m_Size : static_cast<size_t>(m_Ranks.data()[k]);
+    }
+
+    // rank of x in the sorted input, or npos if it is not present
+    size_t find(const T& x) const {
+        const size_t k = descend(x);
+        return k != 0 && !(x < nodes()[k]) ? static_cast<size_t>(m_Ranks.data()[k]) : npos;
+    }
+
+    bool contains(const T& x) const { return find(x) != npos; }
+
+    // lower_bound for every query, spread over the pool
+    SimpelVector<size_t> lower_bound_batch(const SimpelVector<T>& queries) const {
+        SimpelVector<size_t> result;
+        result.resize(queries.size());
+        const T* query = queries.data();
+        size_t* out = result.data();
+        parallel_for(queries.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                out[i] = lower_bound(query[i]);
+            }
+        }, kParallelGrain / 16);
+        return result;
+    }
+
+    void swap(EytzingerVector& other) noexcept {
+        m_Storage.swap(other.m_Storage);
+        m_Ranks.swap(other.m_Ranks);
+        std::swap(m_Offset, other.m_Offset);
+        std::swap(m_Size, other.m_Size);
+    }
+
+    // accessors
+    size_t size() const { return m_Size; }
+    bool empty() const { return m_Size == 0; }
+};
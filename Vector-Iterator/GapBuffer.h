@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "SimpelVector.h"
+
+// Gap buffer for edit-heavy sequences (e.g. a text buffer of char).
+// The elements live in one SimpelVector with a hole (the gap) at the cursor:
+//
+//   [ before cursor ][ ...gap... ][ after cursor ]
+//
+// Inserting or deleting at the cursor only moves the gap's edges, so it is
+// O(1) amortized. Moving the cursor by d shifts d elements across the gap
+// (std::memmove for trivially copyable T), so local edits stay cheap no matter
+// how large the buffer is. Growing reuses SimpelVector's reallocation and then
+// slides the text after the gap to the new end.
+template <typename T>
+class GapBuffer {
+private:
+    SimpelVector<T> m_Buffer; // size() == capacity of the gap buffer, gap included
+    size_t m_GapBegin;        // == cursor position
+    size_t m_GapEnd;
+
+    size_t gap() const { return m_GapEnd - m_GapBegin; }
+
+    // move 'count' elements from src to dst (ranges may overlap)
+    static void move_elements(T* dst, T* src, size_t count) {
+        if (count == 0 || dst == src) {
+            return;
+        }
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memmove(dst, src, count * sizeof(T));
+        } else if (dst < src) {
+            for (size_t i = 0; i < count; ++i) {
+                dst[i] = std::move(src[i]);
+            }
+        } else {
+            for (size_t i = count; i-- > 0;) {
+                dst[i] = std::move(src[i]);
+            }
+        }
+    }
+
+    // make the gap at least 'needed' elements wide, doubling the capacity
+    void ensure_gap(size_t needed) {
+        if (gap() >= needed) {
+            return;
+        }
+        const size_t old_capacity = m_Buffer.size();
+        const size_t suffix = old_capacity - m_GapEnd;
+        size_t new_capacity = old_capacity == 0 ? 16 : old_capacity * 2;
+        while (new_capacity - size() < needed) {
+            new_capacity *= 2;
+        }
+        m_Buffer.resize(new_capacity); // reallocates and moves the old contents to the front
+        T* data = m_Buffer.data();
+        move_elements(data + new_capacity - suffix, data + m_GapEnd, suffix);
+        m_GapEnd = new_capacity - suffix;
+    }
+
+public:
+    GapBuffer() : m_GapBegin(0), m_GapEnd(0) {}
+
+    // insert 'value' at the cursor; the cursor ends up after it
+    // 'value' may be an element of this buffer
+    void insert(const T& value) {
+        T copy = value; // growing may free the buffer 'value' lives in
+        ensure_gap(1);
+        m_Buffer.data()[m_GapBegin++] = std::move(copy);
+    }
+
+    // Insert 'count' values at the cursor. The values may lie inside this
+    // buffer (e.g. a span from before()/after() to duplicate text): growing or
+    // moving the gap would overwrite or free them, so such a range is copied
+    // out first. Ranges from elsewhere are copied straight into the gap.
+    void insert(const T* values, size_t count) {
+        const std::less<const T*> precedes;
+        const T* data_begin = m_Buffer.data();
+        if (count > 0 && data_begin && !precedes(values, data_begin) && precedes(values, data_begin + m_Buffer.size())) {
+            SimpelVector<T> copy;
+            copy.append(values, count);
+            insert(copy.data(), count);
+            return;
+        }
+        ensure_gap(count);
+        T* data = m_Buffer.data();
+        for (size_t i = 0; i < count; ++i) {
+            data[m_GapBegin + i] = values[i];
+        }
+        m_GapBegin += count;
+    }
+
+    // delete 'count' elements before the cursor (backspace)
+    void erase_before(size_t count) {
+        if (count > m_GapBegin) {
+            throw std::out_of_range("Erase before the start of the buffer");
+        }
+        m_GapBegin -= count;
+    }
+
+    // delete 'count' elements after the cursor (delete key)
+    void erase_after(size_t count) {
+        if (count > m_Buffer.size() - m_GapEnd) {
+            throw std::out_of_range("Erase past the end of the buffer");
+        }
+        m_GapEnd += count;
+    }
+
+    // place the cursor before element 'position' (0 .. size())
+    void move_cursor(size_t position) {
+        if (position > size()) {
+            throw std::out_of_range("Cursor out of range");
+        }
+        T* data = m_Buffer.data();
+        if (position < m_GapBegin) {
+            // elements [position, gap_begin) jump to the far side of the gap
+            const size_t count = m_GapBegin - position;
+            move_elements(data + m_GapEnd - count, data + position, count);
+            m_GapBegin -= count;
+            m_GapEnd -= count;
+        } else if (position > m_GapBegin) {
+            const size_t count = position - m_GapBegin;
+            move_elements(data + m_GapBegin, data + m_GapEnd, count);
+            m_GapBegin += count;
+            m_GapEnd += count;
+        }
+    }
+
+    // Index operator: logical position, the gap is skipped
+    T& operator[](size_t index) {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return m_Buffer.data()[index < m_GapBegin ? index : index + gap()];
+    }
+
+    const T& operator[](size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return m_Buffer.data()[index < m_GapBegin ? index : index + gap()];
+    }
+
+    // contiguous views of the two halves (valid until the next edit)
+    std::span<T> before() { return std::span<T>(m_Buffer.data(), m_GapBegin); }
+    std::span<T> after() { return std::span<T>(m_Buffer.data() + m_GapEnd, m_Buffer.size() - m_GapEnd); }
+    std::span<const T> before() const { return std::span<const T>(m_Buffer.data(), m_GapBegin); }
+    std::span<const T> after() const { return std::span<const T>(m_Buffer.data() + m_GapEnd, m_Buffer.size() - m_GapEnd); }
+
+    // copy the contents into a plain SimpelVector
+    SimpelVector<T> to_vector() const {
+        SimpelVector<T> result;
+        result.reserve(size());
+        result.append(m_Buffer.data(), m_GapBegin);
+        result.append(m_Buffer.data() + m_GapEnd, m_Buffer.size() - m_GapEnd);
+        return result;
+    }
+
+    // accessors
+    size_t size() const { return m_Buffer.size() - gap(); }
+    size_t capacity() const { return m_Buffer.size(); }
+    size_t cursor() const { return m_GapBegin; }
+    bool empty() const { return size() == 0; }
+};
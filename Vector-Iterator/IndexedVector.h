@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "SimpelVector.h"
+
+// Dense vector of records plus an open-addressing hash index of their positions,
+// replacing the "SimpelVector<Record> + map<Key, Record*>" pair.
+// KeyOf extracts the key from a record (a functor: key_of(record) -> key).
+//
+// Records are stored contiguously in insertion order and iterated like a plain
+// SimpelVector. The index is a power-of-two table of 8-byte slots
+// (position, 32-bit hash), probed linearly; the hash is kept in the slot so
+// probes rarely touch a record and rehashing never calls Hash again.
+//
+// erase() is swap-and-patch: the last record moves into the hole and its one
+// index slot is updated, so it is O(1) but changes the order of that record.
+// erase_ordered() keeps the order at O(size) cost. Keys of stored records must
+// not be modified through find().
+template <typename T, typename KeyOf, typename Hash = std::hash<std::remove_cvref_t<std::invoke_result_t<KeyOf, const T&>>>>
+class IndexedVector {
+public:
+    using key_type = std::remove_cvref_t<std::invoke_result_t<KeyOf, const T&>>;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    static constexpr uint32_t kEmpty = 0xFFFFFFFF;
+    static constexpr size_t kMaxSize = size_t(1) << 31; // keeps the table within 32-bit hashes
+
+    struct Slot {
+        uint32_t position = kEmpty; // index into m_Values
+        uint32_t hash = 0;          // mixed hash of the key; its low bits pick the home slot
+    };
+
+    SimpelVector<T> m_Values;
+    SimpelVector<Slot> m_Slots; // size is 0 or a power of two
+    KeyOf m_KeyOf;
+    Hash m_Hash;
+
+    size_t mask() const { return m_Slots.size() - 1; }
+
+    // spread std::hash output (often the identity for integers) over all 32 bits
+    uint32_t hash_of(const key_type& key) const {
+        uint64_t h = static_cast<uint64_t>(m_Hash(key));
+        h ^= h >> 32;
+        h *= 0x9E3779B97F4A7C15ull;
+        return static_cast<uint32_t>(h >> 32);
+    }
+
+    // slot holding 'key', or npos
+    size_t find_slot(const key_type& key, uint32_t hash) const {
+        if (m_Slots.empty()) {
+            return npos;
+        }
+        const Slot* slots = m_Slots.data();
+        for (size_t s = hash & mask();; s = (s + 1) & mask()) {
+            if (slots[s].position == kEmpty) {
+                return npos;
+            }
+            if (slots[s].hash == hash && m_KeyOf(m_Values.data()[slots[s].position]) == key) {
+                return s;
+            }
+        }
+    }
+
+    // slot pointing at 'position' (the key is known to be stored)
+    size_t slot_of_position(size_t position, uint32_t hash) const {
+        const Slot* slots = m_Slots.data();
+        size_t s = hash & mask();
+        while (slots[s].position != position) {
+            s = (s + 1) & mask();
+        }
+        return s;
+    }
+
+    void place(Slot slot) {
+        Slot* slots = m_Slots.data();
+        size_t s = slot.hash & mask();
+        while (slots[s].position != kEmpty) {
+            s = (s + 1) & mask();
+        }
+        slots[s] = slot;
+    }
+
+    void rehash(size_t slot_count) {
+        SimpelVector<Slot> old;
+        old.swap(m_Slots);
+        m_Slots.resize(slot_count, Slot());
+        for (const auto& slot : old) {
+            if (slot.position != kEmpty) {
+                place(slot);
+            }
+        }
+    }
+
+    // grow the table so that 'count' records stay below 3/4 load
+    void reserve_slots(size_t count) {
+        size_t slot_count = m_Slots.empty() ? 16 : m_Slots.size();
+        while (count * 4 > slot_count * 3) {
+            slot_count *= 2;
+        }
+        if (slot_count != m_Slots.size()) {
+            rehash(slot_count);
+        }
+    }
+
+    // empty slot 'hole' and shift later members of its probe run back
+    // (backward-shift deletion: linear probing needs no tombstones)
+    void remove_slot(size_t hole) {
+        Slot* slots = m_Slots.data();
+        for (size_t next = (hole + 1) & mask(); slots[next].position != kEmpty; next = (next + 1) & mask()) {
+            const size_t home = slots[next].hash & mask();
+            // move the entry back unless its home lies cyclically in (hole, next]
+            if (((next - home) & mask()) >= ((next - hole) & mask())) {
+                slots[hole] = slots[next];
+                hole = next;
+            }
+        }
+        slots[hole] = Slot();
+    }
+
+public:
+    explicit IndexedVector(KeyOf key_of = KeyOf(), Hash hash = Hash()) : m_KeyOf(key_of), m_Hash(hash) {}
+
+    // Append 'record' unless its key is present. Returns the record's position
+    // and whether it was inserted.
+    std::pair<size_t, bool> insert(const T& record) {
+        const key_type& key = m_KeyOf(record);
+        const uint32_t hash = hash_of(key);
+        const size_t found = find_slot(key, hash);
+        if (found != npos) {
+            return { m_Slots.data()[found].position, false };
+        }
+        if (size() >= kMaxSize) {
+            throw std::length_error("IndexedVector is full");
+        }
+        reserve_slots(size() + 1);
+        m_Values.push_back(record);
+        place(Slot{ static_cast<uint32_t>(size() - 1), hash });
+        return { size() - 1, true };
+    }
+
+    // insert 'record' or overwrite the record with the same key in place
+    size_t insert_or_assign(const T& record) {
+        const auto [position, inserted] = insert(record);
+        if (!inserted) {
+            m_Values.data()[position] = record;
+        }
+        return position;
+    }
+
+    // position of the record with 'key', or npos
+    size_t index_of(const key_type& key) const {
+        const size_t s = find_slot(key, hash_of(key));
+        return s == npos ? npos : m_Slots.data()[s].position;
+    }
+
+    bool contains(const key_type& key) const { return index_of(key) != npos; }
+
+    // pointer to the record with 'key', or nullptr (valid until the next insert/erase)
+    T* find(const key_type& key) {
+        const size_t position = index_of(key);
+        return position == npos ? nullptr : m_Values.data() + position;
+    }
+
+    const T* find(const key_type& key) const {
+        const size_t position = index_of(key);
+        return position == npos ? nullptr : m_Values.data() + position;
+    }
+
+    const T& at(const key_type& key) const {
+        const T* record = find(key);
+        if (!record) {
+            throw std::out_of_range("Key not found");
+        }
+        return *record;
+    }
+
+    // Remove the record with 'key' by moving the last record into its place.
+    bool erase(const key_type& key) {
+        const size_t s = find_slot(key, hash_of(key));
+        if (s == npos) {
+            return false;
+        }
+        const size_t position = m_Slots.data()[s].position;
+        const size_t last = size() - 1;
+        remove_slot(s);
+        if (position != last) {
+            T* values = m_Values.data();
+            const size_t moved = slot_of_position(last, hash_of(m_KeyOf(values[last])));
+            m_Slots.data()[moved].position = static_cast<uint32_t>(position);
+            values[position] = std::move(values[last]);
+        }
+        m_Values.pop_back();
+        return true;
+    }
+
+    // Remove the record with 'key' and keep the order of the others: later
+    // records shift down by one and every slot pointing past 'key' is patched.
+    bool erase_ordered(const key_type& key) {
+        const size_t s = find_slot(key, hash_of(key));
+        if (s == npos) {
+            return false;
+        }
+        const uint32_t position = m_Slots.data()[s].position;
+        remove_slot(s);
+        T* values = m_Values.data();
+        for (size_t i = position; i + 1 < size(); ++i) {
+            values[i] = std::move(values[i + 1]);
+        }
+        m_Values.pop_back();
+        for (auto& slot : m_Slots) {
+            if (slot.position != kEmpty && slot.position > position) {
+                --slot.position;
+            }
+        }
+        return true;
+    }
+
+    // make room for 'count' records without reallocating or rehashing
+    void reserve(size_t count) {
+        m_Values.reserve(count);
+        reserve_slots(count);
+    }
+
+    void clear() {
+        m_Values.clear();
+        for (auto& slot : m_Slots) {
+            slot = Slot();
+        }
+    }
+
+    // Index operator: record by position (checks bounds)
+    const T& operator[](size_t position) const { return m_Values[position]; }
+
+    // accessors
+    size_t size() const { return m_Values.size(); }
+    bool empty() const { return m_Values.empty(); }
+    const SimpelVector<T>& values() const { return m_Values; }
+
+    // iteration in storage order over contiguous records
+    typename SimpelVector<T>::ConstIterator begin() const { return m_Values.cbegin(); }
+    typename SimpelVector<T>::ConstIterator end() const { return m_Values.cend(); }
+};
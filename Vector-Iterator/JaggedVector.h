@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include "SimpelVector.h"
+#include "Parallel.h"
+
+// Vector of variable-length rows flattened into one value buffer (CSR layout).
+// Row i occupies values [begin[i], begin[i] + size[i]) and owns capacity[i]
+// slots there, so a row can take push_backs in place until its slack runs out.
+// A full row that is not the last one in the buffer is moved to the end with
+// doubled capacity; the slots it leaves behind are garbage, and once garbage
+// outweighs the live values the buffer is compacted. After build() or compact()
+// rows are stored in order without gaps, i.e. plain CSR.
+//
+// Compared to SimpelVector<SimpelVector<T>> this is one allocation instead of
+// one per row, rows are adjacent in memory, and no row objects get copied or moved.
+template <typename T>
+class JaggedVector {
+private:
+    SimpelVector<T> m_Values;
+    SimpelVector<size_t> m_Begin;    // first slot of each row in m_Values
+    SimpelVector<size_t> m_Size;     // elements per row
+    SimpelVector<size_t> m_Capacity; // slots owned by each row
+    size_t m_Live;                   // sum of all row sizes
+    size_t m_Garbage;                // slots no row owns any more
+
+    void check_row(size_t row) const {
+        if (row >= rows()) {
+            throw std::out_of_range("Row index out of range");
+        }
+    }
+
+    // resize the value buffer, growing its capacity geometrically like push_back
+    void resize_values(size_t new_size) {
+        if (new_size > m_Values.capacity()) {
+            m_Values.reserve(new_size > 2 * m_Values.capacity() ? new_size : 2 * m_Values.capacity());
+        }
+        m_Values.resize(new_size);
+    }
+
+    void maybe_compact() {
+        if (m_Garbage > m_Live) {
+            compact();
+        }
+    }
+
+public:
+    JaggedVector() : m_Live(0), m_Garbage(0) {}
+
+    // Two-pass CSR construction from (row_ids[i], values[i]) pairs:
+    // count per row, prefix-sum the counts into row starts, then scatter.
+    // Values keep their input order within a row. Large inputs run on the pool
+    // with private per-chunk counts, so the scatter needs no synchronization.
+    static JaggedVector build(size_t rows, const SimpelVector<size_t>& row_ids, const SimpelVector<T>& values) {
+        if (row_ids.size() != values.size()) {
+            throw std::invalid_argument("build needs one row id per value");
+        }
+        const size_t n = values.size();
+        const size_t* ids = row_ids.data();
+        const T* in = values.data();
+
+        // per-chunk counts cost rows * chunks: only go parallel when that is small next to n
+        size_t chunks = parallel_chunk_count(n);
+        if (rows * chunks > n) {
+            chunks = 1;
+        }
+
+        // pass 1: counts[chunk * rows + row]
+        SimpelVector<size_t> counts;
+        counts.resize(chunks * rows, 0);
+        size_t* count = counts.data();
+        parallel_chunks(n, chunks, [&](size_t chunk, size_t begin, size_t end) {
+            size_t* local = count + chunk * rows;
+            for (size_t i = begin; i < end; ++i) {
+                if (ids[i] >= rows) {
+                    throw std::out_of_range("Row index out of range");
+                }
+                ++local[ids[i]];
+            }
+        });
+
+        JaggedVector result;
+        result.m_Begin.resize(rows);
+        result.m_Size.resize(rows);
+        result.m_Capacity.resize(rows);
+
+        // prefix sum in (row, chunk) order turns counts into write cursors
+        size_t offset = 0;
+        for (size_t row = 0; row < rows; ++row) {
+            result.m_Begin.data()[row] = offset;
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                const size_t c = count[chunk * rows + row];
+                count[chunk * rows + row] = offset;
+                offset += c;
+            }
+            result.m_Size.data()[row] = offset - result.m_Begin.data()[row];
+            result.m_Capacity.data()[row] = result.m_Size.data()[row];
+        }
+
+        // pass 2: scatter every value to its row's cursor
+        result.m_Values.resize(n);
+        T* out = result.m_Values.data();
+        parallel_chunks(n, chunks, [&](size_t chunk, size_t begin, size_t end) {
+            size_t* cursor = count + chunk * rows;
+            for (size_t i = begin; i < end; ++i) {
+                out[cursor[ids[i]]++] = in[i];
+            }
+        });
+        result.m_Live = n;
+        return result;
+    }
+
+    // append a new row with the given values; returns its index
+    // values must not point into this container, since growing frees the old buffer
+    size_t append_row(std::span<const T> values) {
+        m_Begin.push_back(m_Values.size());
+        m_Size.push_back(values.size());
+        m_Capacity.push_back(values.size());
+        m_Values.append(values.data(), values.size());
+        m_Live += values.size();
+        return rows() - 1;
+    }
+
+    size_t append_row() { return append_row(std::span<const T>()); }
+
+    // append 'value' to row 'row' (in place while the row has slack)
+    // 'value' may refer to an element of this container
+    void push_back(size_t row, const T& value) {
+        check_row(row);
+        T copy = value; // growing below may free the buffer 'value' lives in
+        size_t& begin = m_Begin.data()[row];
+        size_t& size = m_Size.data()[row];
+        size_t& capacity = m_Capacity.data()[row];
+
+        if (size == capacity) {
+            if (begin + capacity == m_Values.size()) {
+                // last row in the buffer: its slack can simply grow at the end
+                const size_t grown = capacity == 0 ? 1 : capacity * 2;
+                resize_values(begin + grown);
+                capacity = grown;
+            } else {
+                // move the row to the end of the buffer with doubled capacity
+                const size_t grown = capacity == 0 ? 1 : capacity * 2;
+                const size_t new_begin = m_Values.size();
+                resize_values(new_begin + grown);
+                T* data = m_Values.data();
+                for (size_t i = 0; i < size; ++i) {
+                    data[new_begin + i] = std::move(data[begin + i]);
+                }
+                m_Garbage += capacity;
+                begin = new_begin;
+                capacity = grown;
+            }
+        }
+        m_Values.data()[begin + size] = std::move(copy);
+        ++size;
+        ++m_Live;
+        maybe_compact();
+    }
+
+    // remove the last element of row 'row'
+    void pop_back(size_t row) {
+        check_row(row);
+        if (m_Size.data()[row] == 0) {
+            throw std::out_of_range("Row is empty");
+        }
+        --m_Size.data()[row];
+        --m_Live;
+    }
+
+    // Repack all rows in order without slack or garbage (plain CSR afterwards).
+    void compact() {
+        SimpelVector<T> packed;
+        packed.reserve(m_Live);
+        for (size_t row = 0; row < rows(); ++row) {
+            const size_t begin = m_Begin.data()[row];
+            const size_t size = m_Size.data()[row];
+            m_Begin.data()[row] = packed.size();
+            m_Capacity.data()[row] = size;
+            for (size_t i = 0; i < size; ++i) {
+                packed.push_back(std::move(m_Values.data()[begin + i]));
+            }
+        }
+        m_Values.swap(packed);
+        m_Garbage = 0;
+    }
+
+    // Row access: spans stay valid until the next push_back/append_row/compact
+    std::span<T> operator[](size_t row) {
+        check_row(row);
+        return std::span<T>(m_Values.data() + m_Begin.data()[row], m_Size.data()[row]);
+    }
+
+    std::span<const T> operator[](size_t row) const {
+        check_row(row);
+        return std::span<const T>(m_Values.data() + m_Begin.data()[row], m_Size.data()[row]);
+    }
+
+    // accessors
+    size_t rows() const { return m_Begin.size(); }
+    size_t size() const { return m_Live; }       // number of values over all rows
+    size_t garbage() const { return m_Garbage; } // dead slots waiting for compact()
+    bool empty() const { return rows() == 0; }
+    size_t row_size(size_t row) const {
+        check_row(row);
+        return m_Size.data()[row];
+    }
+};
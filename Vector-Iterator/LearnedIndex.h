@@ -0,0 +1,239 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "SimpelVector.h"
+#include "SortedSearch.h"
+
+// Learned index over a sorted SimpelVector, in the style of the PGM-index:
+// the key -> rank function is approximated by piecewise linear segments, each
+// guaranteed to predict the rank of every key it covers to within 'epsilon'.
+// A lookup evaluates one segment and then searches only the 2 * epsilon + 1
+// keys around the prediction with sorted_rank (SIMD for integer keys) instead
+// of bisecting the whole vector.
+//
+// Segments are found the same way, recursively: the first keys of the
+// segments of one level are indexed by the (much fewer) segments of the next
+// level, with the smaller 'inner_epsilon', up to a single root segment.
+// Segments are built in one greedy pass per level (shrinking cone): a segment
+// grows while some slope still keeps all of its keys within epsilon.
+//
+// The index does not copy the keys: it refers to the vector it was built over,
+// which has to outlive it and stay unchanged. Its own size is only the
+// segments (see bytes()), typically a small fraction of the keys.
+template <typename Key>
+class LearnedIndex {
+    static_assert(std::is_arithmetic_v<Key>, "LearnedIndex needs arithmetic keys");
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    struct Segment {
+        double slope = 0; // ranks per key unit
+        size_t rank = 0;  // rank of the segment's first key
+    };
+
+    // Greedy segmentation of (key, rank) points with increasing keys: keeps the
+    // range of slopes through the segment's first point that fit every point
+    // added so far, and closes the segment once that range becomes empty.
+    class SegmentBuilder {
+    private:
+        SimpelVector<Key>& m_Keys;
+        SimpelVector<Segment>& m_Segments;
+        double m_Epsilon;
+        Key m_First;
+        size_t m_FirstRank;
+        double m_Low;
+        double m_High;
+        bool m_Open;
+
+        void close() {
+            const bool single = m_High == std::numeric_limits<double>::infinity();
+            m_Keys.push_back(m_First);
+            m_Segments.push_back(Segment{ single ? 0.0 : (m_Low + m_High) / 2, m_FirstRank });
+        }
+
+    public:
+        SegmentBuilder(SimpelVector<Key>& keys, SimpelVector<Segment>& segments, size_t epsilon)
+            : m_Keys(keys), m_Segments(segments), m_Epsilon(static_cast<double>(epsilon)), m_First(),
+              m_FirstRank(0), m_Low(0), m_High(0), m_Open(false) {}
+
+        void add(const Key& key, size_t rank) {
+            if (m_Open) {
+                const double dx = distance(m_First, key);
+                const double dy = static_cast<double>(rank) - static_cast<double>(m_FirstRank);
+                const double low = (dy - m_Epsilon) / dx;
+                const double high = (dy + m_Epsilon) / dx;
+                if ((low > m_Low ? low : m_Low) <= (high < m_High ? high : m_High)) {
+                    m_Low = low > m_Low ? low : m_Low;
+                    m_High = high < m_High ? high : m_High;
+                    return;
+                }
+                close();
+            }
+            m_First = key;
+            m_FirstRank = rank;
+            m_Low = 0;
+            m_High = std::numeric_limits<double>::infinity();
+            m_Open = true;
+        }
+
+        void finish() {
+            if (m_Open) {
+                close();
+                m_Open = false;
+            }
+        }
+    };
+
+    const SimpelVector<Key>* m_Data;   // the indexed keys (not owned)
+    SimpelVector<Key> m_SegmentKeys;   // first key of every segment, level by level
+    SimpelVector<Segment> m_Segments;  // parallel to m_SegmentKeys
+    SimpelVector<size_t> m_LevelBegin; // level l is [m_LevelBegin[l], m_LevelBegin[l + 1]), level 0 over the data
+    size_t m_Epsilon;
+    size_t m_InnerEpsilon;
+
+    // key - first as a double; exact for integer keys less than 2^53 apart
+    static double distance(const Key& first, const Key& key) {
+        if constexpr (std::is_integral_v<Key>) {
+            using Unsigned = std::make_unsigned_t<Key>;
+            return static_cast<double>(static_cast<Unsigned>(static_cast<Unsigned>(key) - static_cast<Unsigned>(first)));
+        } else {
+            return static_cast<double>(key) - static_cast<double>(first);
+        }
+    }
+
+    // Rank of x among keys[0..n) (OrEqual as in sorted_rank), starting from a
+    // prediction that is expected to be within 'radius'. The window is widened
+    // (doubling) until the keys just outside it confirm the answer is inside,
+    // so floating-point slack or an off prediction costs time, never results.
+    template <bool OrEqual>
+    static size_t bounded_rank(const Key* keys, size_t n, const Key& x, size_t guess, size_t radius) {
+        const auto below = [&](size_t i) { return OrEqual ? !(x < keys[i]) : keys[i] < x; };
+        size_t low = guess > radius ? guess - radius : 0;
+        size_t high = guess + radius + 1 < n ? guess + radius + 1 : n;
+        while (low > 0 && !below(low - 1)) {
+            const size_t width = high - low + 1;
+            low = low > width ? low - width : 0;
+        }
+        while (high < n && below(high)) {
+            const size_t width = high - low + 1;
+            high = n - high > width ? high + width : n;
+        }
+        return low + sorted_rank<OrEqual>(keys + low, high - low, x);
+    }
+
+    // rank predicted by segment 'index' (global), clamped to the ranks it covers
+    size_t predict(size_t index, const Key& x, size_t level_end, size_t target_size) const {
+        const Segment& segment = m_Segments.data()[index];
+        const size_t limit = index + 1 < level_end ? m_Segments.data()[index + 1].rank : target_size;
+        const double position = static_cast<double>(segment.rank)
+            + segment.slope * distance(m_SegmentKeys.data()[index], x);
+        if (!(position > static_cast<double>(segment.rank))) {
+            return segment.rank;
+        }
+        if (position >= static_cast<double>(limit)) {
+            return limit;
+        }
+        return static_cast<size_t>(position + 0.5);
+    }
+
+public:
+    LearnedIndex() : m_Data(nullptr), m_Epsilon(0), m_InnerEpsilon(0) {}
+
+    // Build over a sorted (non-decreasing) vector. Duplicate keys are modelled
+    // by their first occurrence, which is what lower_bound returns.
+    explicit LearnedIndex(const SimpelVector<Key>& sorted, size_t epsilon = 64, size_t inner_epsilon = 4)
+        : m_Data(&sorted), m_Epsilon(epsilon), m_InnerEpsilon(inner_epsilon) {
+        if (epsilon == 0 || inner_epsilon == 0) {
+            throw std::invalid_argument("LearnedIndex needs a positive epsilon");
+        }
+        const Key* keys = sorted.data();
+        const size_t n = sorted.size();
+        m_LevelBegin.push_back(0);
+        if (n == 0) {
+            m_LevelBegin.push_back(0);
+            return;
+        }
+
+        SegmentBuilder data_level(m_SegmentKeys, m_Segments, epsilon);
+        for (size_t i = 0; i < n; ++i) {
+            if (i > 0 && keys[i] < keys[i - 1]) {
+                throw std::invalid_argument("LearnedIndex needs sorted input");
+            }
+            if (i == 0 || keys[i - 1] < keys[i]) {
+                data_level.add(keys[i], i);
+            }
+        }
+        data_level.finish();
+        m_LevelBegin.push_back(m_Segments.size());
+
+        // index each level's segments with the next, until one segment is left
+        while (m_LevelBegin[m_LevelBegin.size() - 1] - m_LevelBegin[m_LevelBegin.size() - 2] > 1) {
+            const size_t begin = m_LevelBegin[m_LevelBegin.size() - 2];
+            const size_t end = m_LevelBegin[m_LevelBegin.size() - 1];
+            SegmentBuilder level(m_SegmentKeys, m_Segments, inner_epsilon);
+            for (size_t index = begin; index < end; ++index) {
+                // copied: the builder appends to the same vector, which may reallocate
+                const Key first = m_SegmentKeys.data()[index];
+                level.add(first, index - begin);
+            }
+            level.finish();
+            m_LevelBegin.push_back(m_Segments.size());
+        }
+    }
+
+    // Rank of the first key >= x in the indexed vector (size() if there is none).
+    size_t lower_bound(const Key& x) const {
+        const size_t n = size();
+        if (n == 0 || !(m_Data->data()[0] < x)) {
+            return 0;
+        }
+        // x > first key, so every level has a last segment starting at or below x
+        size_t level = levels() - 1;
+        size_t index = m_LevelBegin[level]; // the root
+        while (level > 0) {
+            const size_t begin = m_LevelBegin[level - 1];
+            const size_t count = m_LevelBegin[level] - begin;
+            const size_t guess = predict(index, x, m_LevelBegin[level + 1], count);
+            index = begin + bounded_rank<true>(m_SegmentKeys.data() + begin, count, x, guess, m_InnerEpsilon + 1) - 1;
+            --level;
+        }
+        const size_t guess = predict(index, x, m_LevelBegin[1], n);
+        return bounded_rank<false>(m_Data->data(), n, x, guess, m_Epsilon + 1);
+    }
+
+    // rank of (the first occurrence of) x, or npos if it is not present
+    size_t find(const Key& x) const {
+        const size_t rank = lower_bound(x);
+        return rank < size() && !(x < m_Data->data()[rank]) ? rank : npos;
+    }
+
+    bool contains(const Key& x) const { return find(x) != npos; }
+
+    void swap(LearnedIndex& other) noexcept {
+        std::swap(m_Data, other.m_Data);
+        m_SegmentKeys.swap(other.m_SegmentKeys);
+        m_Segments.swap(other.m_Segments);
+        m_LevelBegin.swap(other.m_LevelBegin);
+        std::swap(m_Epsilon, other.m_Epsilon);
+        std::swap(m_InnerEpsilon, other.m_InnerEpsilon);
+    }
+
+    // accessors
+    size_t size() const { return m_Data ? m_Data->size() : 0; }
+    bool empty() const { return size() == 0; }
+    size_t epsilon() const { return m_Epsilon; }
+    size_t levels() const { return m_LevelBegin.size() > 0 ? m_LevelBegin.size() - 1 : 0; }
+    size_t segments() const { return m_LevelBegin.size() > 1 ? m_LevelBegin[1] : 0; } // over the data
+    size_t bytes() const {
+        return m_SegmentKeys.capacity() * sizeof(Key) + m_Segments.capacity() * sizeof(Segment)
+            + m_LevelBegin.capacity() * sizeof(size_t);
+    }
+};
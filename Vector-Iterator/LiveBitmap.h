@@ -0,0 +1,296 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "SimpelVector.h"
+#include "Parallel.h"
+
+// Three-level bitmap of live elements for a tombstoned vector.
+//
+//   level 0: one bit per element
+//   level 1: one bit per level-0 word (set if that word has any live bit)
+//   level 2: one bit per level-1 word
+//
+// find_next() skips 64 dead words per level-1 bit and 4096 per level-2 bit,
+// using countr_zero (tzcnt) at every level, so iterating the live elements costs
+// O(live + live_words) instead of O(size) however many tombstones there are.
+class LiveBitmap {
+private:
+    size_t m_Size;
+    SimpelVector<uint64_t> m_Bits;    // level 0
+    SimpelVector<uint64_t> m_Words;   // level 1
+    SimpelVector<uint64_t> m_Summary; // level 2
+
+    static size_t words_for(size_t bits) { return (bits + 63) / 64; }
+
+    // recompute level-1 and level-2 bits covering level-0 word 'word'
+    void refresh(size_t word) {
+        const size_t w1 = word / 64;
+        const uint64_t bit1 = uint64_t(1) << (word % 64);
+        if (m_Bits.data()[word]) {
+            m_Words.data()[w1] |= bit1;
+        } else {
+            m_Words.data()[w1] &= ~bit1;
+        }
+        const size_t w2 = w1 / 64;
+        const uint64_t bit2 = uint64_t(1) << (w1 % 64);
+        if (m_Words.data()[w1]) {
+            m_Summary.data()[w2] |= bit2;
+        } else {
+            m_Summary.data()[w2] &= ~bit2;
+        }
+    }
+
+    // rebuild levels 1 and 2 from level 0
+    void rebuild_summaries() {
+        const uint64_t* bits = m_Bits.data();
+        uint64_t* words = m_Words.data();
+        parallel_for(m_Words.size(), [&](size_t begin, size_t end) {
+            for (size_t w1 = begin; w1 < end; ++w1) {
+                uint64_t summary = 0;
+                const size_t first = w1 * 64;
+                const size_t last = first + 64 < m_Bits.size() ? first + 64 : m_Bits.size();
+                for (size_t w = first; w < last; ++w) {
+                    summary |= uint64_t(bits[w] != 0) << (w - first);
+                }
+                words[w1] = summary;
+            }
+        }, kParallelGrain / 64);
+        for (size_t w2 = 0; w2 < m_Summary.size(); ++w2) {
+            uint64_t summary = 0;
+            const size_t first = w2 * 64;
+            const size_t last = first + 64 < m_Words.size() ? first + 64 : m_Words.size();
+            for (size_t w = first; w < last; ++w) {
+                summary |= uint64_t(words[w] != 0) << (w - first);
+            }
+            m_Summary.data()[w2] = summary;
+        }
+    }
+
+public:
+    // 'size' elements, all live (or all dead)
+    explicit LiveBitmap(size_t size = 0, bool live = true) : m_Size(0) { resize(size, live); }
+
+    // grow or shrink to 'size' elements; new elements get state 'live'
+    void resize(size_t size, bool live = true) {
+        const size_t old_size = m_Size;
+        m_Bits.resize(words_for(size), 0);
+        m_Words.resize(words_for(m_Bits.size()), 0);
+        m_Summary.resize(words_for(m_Words.size()), 0);
+        m_Size = size;
+
+        if (size < old_size) {
+            // clear bits past the new end so they are never found
+            if (size % 64) {
+                m_Bits.data()[size / 64] &= (uint64_t(1) << (size % 64)) - 1;
+            }
+        } else if (live) {
+            uint64_t* bits = m_Bits.data();
+            for (size_t i = old_size; i < size;) {
+                if (i % 64 == 0 && i + 64 <= size) {
+                    bits[i / 64] = ~uint64_t(0); // whole word at once
+                    i += 64;
+                } else {
+                    bits[i / 64] |= uint64_t(1) << (i % 64);
+                    ++i;
+                }
+            }
+        }
+        rebuild_summaries();
+    }
+
+    // append one element
+    void push_back(bool live) {
+        const size_t index = m_Size;
+        if (index % 64 == 0) {
+            m_Bits.push_back(0);
+            if (m_Bits.size() > m_Words.size() * 64) {
+                m_Words.push_back(0);
+                if (m_Words.size() > m_Summary.size() * 64) {
+                    m_Summary.push_back(0);
+                }
+            }
+        }
+        ++m_Size;
+        if (live) {
+            set(index);
+        }
+    }
+
+    bool test(size_t index) const {
+        if (index >= m_Size) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (m_Bits.data()[index / 64] >> (index % 64)) & 1;
+    }
+
+    // mark element 'index' live
+    void set(size_t index) {
+        if (index >= m_Size) {
+            throw std::out_of_range("Index out of range");
+        }
+        const size_t word = index / 64;
+        const bool was_empty = m_Bits.data()[word] == 0;
+        m_Bits.data()[word] |= uint64_t(1) << (index % 64);
+        if (was_empty) {
+            refresh(word);
+        }
+    }
+
+    // tombstone element 'index'
+    void reset(size_t index) {
+        if (index >= m_Size) {
+            throw std::out_of_range("Index out of range");
+        }
+        const size_t word = index / 64;
+        m_Bits.data()[word] &= ~(uint64_t(1) << (index % 64));
+        if (m_Bits.data()[word] == 0) {
+            refresh(word);
+        }
+    }
+
+    // Tombstone a batch of elements. Level-0 words are cleared in parallel with
+    // atomic ANDs (indices may share words); the summaries are rebuilt once.
+    // A bad index throws std::out_of_range before any bit is cleared.
+    template <typename Index>
+    void reset_batch(const SimpelVector<Index>& indices) {
+        const Index* idx = indices.data();
+        uint64_t* bits = m_Bits.data();
+        const size_t size = m_Size;
+        // validate everything first: a chunk throwing halfway would leave the
+        // other chunks' bits cleared and the summaries stale
+        parallel_for(indices.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (static_cast<size_t>(idx[i]) >= size) {
+                    throw std::out_of_range("Index out of range");
+                }
+            }
+        });
+        parallel_for(indices.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const size_t index = static_cast<size_t>(idx[i]);
+                std::atomic_ref<uint64_t>(bits[index / 64]).fetch_and(~(uint64_t(1) << (index % 64)));
+            }
+        });
+        rebuild_summaries();
+    }
+
+    // First live index >= from, or size() if there is none.
+    size_t find_next(size_t from) const {
+        if (from >= m_Size) {
+            return m_Size;
+        }
+        const uint64_t* bits = m_Bits.data();
+        const uint64_t* words = m_Words.data();
+        const uint64_t* summary = m_Summary.data();
+
+        // rest of the current level-0 word
+        size_t word = from / 64;
+        uint64_t current = bits[word] & (~uint64_t(0) << (from % 64));
+        if (current) {
+            return word * 64 + static_cast<size_t>(std::countr_zero(current));
+        }
+
+        // rest of the current level-1 word
+        size_t w1 = (word + 1) / 64;
+        if (w1 >= m_Words.size()) {
+            return m_Size;
+        }
+        uint64_t mask1 = (word + 1) % 64 ? words[w1] & (~uint64_t(0) << ((word + 1) % 64)) : words[w1];
+        if (!mask1) {
+            // climb to level 2 to skip whole level-1 words
+            size_t w2 = (w1 + 1) / 64;
+            if (w2 >= m_Summary.size()) {
+                return m_Size;
+            }
+            uint64_t mask2 = (w1 + 1) % 64 ? summary[w2] & (~uint64_t(0) << ((w1 + 1) % 64)) : summary[w2];
+            while (!mask2) {
+                if (++w2 >= m_Summary.size()) {
+                    return m_Size;
+                }
+                mask2 = summary[w2];
+            }
+            w1 = w2 * 64 + static_cast<size_t>(std::countr_zero(mask2));
+            mask1 = words[w1];
+        }
+        word = w1 * 64 + static_cast<size_t>(std::countr_zero(mask1));
+        return word * 64 + static_cast<size_t>(std::countr_zero(bits[word]));
+    }
+
+    // call fn(index) for every live element in increasing order
+    template <typename F>
+    void for_each_live(F fn) const {
+        for (size_t i = find_next(0); i < m_Size; i = find_next(i + 1)) {
+            fn(i);
+        }
+    }
+
+    // number of live elements
+    size_t count() const {
+        size_t live = 0;
+        for (size_t w = 0; w < m_Bits.size(); ++w) {
+            live += static_cast<size_t>(std::popcount(m_Bits.data()[w]));
+        }
+        return live;
+    }
+
+    size_t size() const { return m_Size; }
+    const uint64_t* words() const { return m_Bits.data(); } // level 0, size() bits
+
+    void swap(LiveBitmap& other) noexcept {
+        std::swap(m_Size, other.m_Size);
+        m_Bits.swap(other.m_Bits);
+        m_Words.swap(other.m_Words);
+        m_Summary.swap(other.m_Summary);
+    }
+};
+
+// Remove every tombstoned element of 'values' (keeping the order of the live
+// ones) and reset 'live' to all-live at the new size. Chunks of whole bitmap
+// words popcount their live elements, a prefix sum over the chunk counts gives
+// each chunk its output offset, and the chunks then move their survivors in parallel.
+template <typename T>
+void compact(SimpelVector<T>& values, LiveBitmap& live) {
+    if (live.size() != values.size()) {
+        throw std::invalid_argument("Bitmap size does not match vector size");
+    }
+    const size_t words = (values.size() + 63) / 64;
+    const size_t chunks = parallel_chunk_count(values.size());
+    const uint64_t* bits = live.words();
+
+    SimpelVector<size_t> offsets;
+    offsets.resize(chunks + 1, 0);
+    size_t* offset = offsets.data();
+    parallel_chunks(words, chunks, [&](size_t chunk, size_t begin, size_t end) {
+        size_t count = 0;
+        for (size_t w = begin; w < end; ++w) {
+            count += static_cast<size_t>(std::popcount(bits[w]));
+        }
+        offset[chunk + 1] = count;
+    });
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        offset[chunk + 1] += offset[chunk];
+    }
+
+    SimpelVector<T> packed;
+    packed.resize(offset[chunks]);
+    T* out = packed.data();
+    T* in = values.data();
+    parallel_chunks(words, chunks, [&](size_t chunk, size_t begin, size_t end) {
+        size_t position = offset[chunk];
+        for (size_t w = begin; w < end; ++w) {
+            for (uint64_t word = bits[w]; word; word &= word - 1) {
+                out[position++] = std::move(in[w * 64 + static_cast<size_t>(std::countr_zero(word))]);
+            }
+        }
+    });
+
+    values.swap(packed);
+    LiveBitmap fresh(values.size(), true);
+    live.swap(fresh);
+}
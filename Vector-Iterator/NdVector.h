@@ -0,0 +1,297 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "SimpelVector.h"
+
+// Memory layouts for NdVector
+enum class NdLayout {
+    RowMajor,    // last index is contiguous (C order)
+    ColumnMajor, // first index is contiguous (Fortran order)
+    Tiled        // last two indices are stored in square tile x tile blocks, blocks in row-major order
+};
+
+// Owning multi-dimensional array on top of one SimpelVector buffer.
+// The contiguous dimension of the strided layouts is padded to a multiple of
+// 64 bytes and the first element is 64-byte aligned, so every row (or column)
+// starts on a cache line / SIMD boundary.
+//
+// For RowMajor and ColumnMajor the accessors follow std::mdspan with
+// layout_stride: extent(r), stride(r), data_handle(), required_span_size().
+// That is enough to build a std::mdspan view over an NdVector where the
+// standard library provides it. Tiled layouts are not strided; stride() throws
+// for them and element access goes through operator().
+template <typename T, size_t Rank>
+class NdVector {
+    static_assert(Rank >= 1, "NdVector needs at least one dimension");
+
+public:
+    using value_type = T;
+    using Extents = std::array<size_t, Rank>;
+    static constexpr size_t kAlignBytes = 64;
+
+private:
+    SimpelVector<T> m_Storage; // elements, plus slack to align the first one
+    size_t m_Offset;           // index in m_Storage of element (0, ..., 0)
+    size_t m_Span;             // number of element slots including padding
+    Extents m_Extents;
+    Extents m_Strides;         // strided layouts only
+    NdLayout m_Layout;
+    size_t m_TileShift;        // log2 of the tile edge (Tiled only)
+    size_t m_TilesPerRow;      // tiles along the last dimension (Tiled only)
+
+    // number of elements that make up kAlignBytes (1 if T does not divide it)
+    static constexpr size_t align_elements() {
+        return kAlignBytes % sizeof(T) == 0 ? kAlignBytes / sizeof(T) : 1;
+    }
+
+    static size_t round_up(size_t value, size_t multiple) {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    // allocate storage for m_Span elements with an aligned first element
+    void allocate(const T& value) {
+        const size_t slack = align_elements() - 1;
+        m_Storage.resize(m_Span + slack, value);
+        m_Offset = aligned_offset(m_Storage.data());
+    }
+
+    static size_t aligned_offset(const T* data) {
+        if (align_elements() == 1) {
+            return 0;
+        }
+        const uintptr_t address = reinterpret_cast<uintptr_t>(data);
+        const uintptr_t aligned = (address + kAlignBytes - 1) & ~(uintptr_t(kAlignBytes) - 1);
+        return static_cast<size_t>(aligned - address) / sizeof(T);
+    }
+
+    void compute_layout(size_t tile) {
+        if (m_Layout == NdLayout::Tiled) {
+            if (Rank < 2) {
+                throw std::invalid_argument("Tiled layout needs at least two dimensions");
+            }
+            if (tile == 0 || !std::has_single_bit(tile)) {
+                throw std::invalid_argument("Tile size must be a power of two");
+            }
+            m_TileShift = static_cast<size_t>(std::countr_zero(tile));
+            const size_t rows = round_up(m_Extents[Rank - 2], tile);
+            const size_t cols = round_up(m_Extents[Rank - 1], tile);
+            m_TilesPerRow = cols / tile;
+            m_Span = rows * cols;
+            for (size_t r = 0; r + 2 < Rank; ++r) {
+                m_Span *= m_Extents[r];
+            }
+            m_Strides.fill(0);
+            return;
+        }
+
+        m_TileShift = 0;
+        m_TilesPerRow = 0;
+        if (m_Layout == NdLayout::RowMajor) {
+            size_t stride = 1;
+            for (size_t r = Rank; r-- > 0;) {
+                m_Strides[r] = stride;
+                stride *= r == Rank - 1 && Rank > 1 ? round_up(m_Extents[r], align_elements()) : m_Extents[r];
+            }
+            m_Span = stride;
+        } else {
+            size_t stride = 1;
+            for (size_t r = 0; r < Rank; ++r) {
+                m_Strides[r] = stride;
+                stride *= r == 0 && Rank > 1 ? round_up(m_Extents[r], align_elements()) : m_Extents[r];
+            }
+            m_Span = stride;
+        }
+    }
+
+public:
+    NdVector() : m_Offset(0), m_Span(0), m_Extents(), m_Strides(), m_Layout(NdLayout::RowMajor), m_TileShift(0), m_TilesPerRow(0) {}
+
+    // extents: size of each dimension; tile: edge of the square tiles (Tiled only, power of two)
+    explicit NdVector(const Extents& extents, NdLayout layout = NdLayout::RowMajor, size_t tile = 16, const T& value = T())
+        : m_Offset(0), m_Span(0), m_Extents(extents), m_Strides(), m_Layout(layout), m_TileShift(0), m_TilesPerRow(0) {
+        compute_layout(tile);
+        allocate(value);
+    }
+
+    // Copies get a fresh buffer whose alignment slack may differ, so the padded
+    // element range is copied to the new aligned position.
+    NdVector(const NdVector& other)
+        : m_Offset(0), m_Span(other.m_Span), m_Extents(other.m_Extents), m_Strides(other.m_Strides),
+          m_Layout(other.m_Layout), m_TileShift(other.m_TileShift), m_TilesPerRow(other.m_TilesPerRow) {
+        allocate(T());
+        const T* src = other.data_handle();
+        T* dst = data_handle();
+        for (size_t i = 0; i < m_Span; ++i) {
+            dst[i] = src[i];
+        }
+    }
+
+    NdVector& operator=(const NdVector& other) {
+        if (this != &other) {
+            NdVector copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    // moves keep the buffer, so the aligned offset stays valid
+    NdVector(NdVector&& other) noexcept = default;
+    NdVector& operator=(NdVector&& other) noexcept = default;
+
+    void swap(NdVector& other) noexcept {
+        m_Storage.swap(other.m_Storage);
+        std::swap(m_Offset, other.m_Offset);
+        std::swap(m_Span, other.m_Span);
+        std::swap(m_Extents, other.m_Extents);
+        std::swap(m_Strides, other.m_Strides);
+        std::swap(m_Layout, other.m_Layout);
+        std::swap(m_TileShift, other.m_TileShift);
+        std::swap(m_TilesPerRow, other.m_TilesPerRow);
+    }
+
+    // position of an element relative to data_handle()
+    size_t offset(const Extents& idx) const {
+        if (m_Layout != NdLayout::Tiled) {
+            size_t result = 0;
+            for (size_t r = 0; r < Rank; ++r) {
+                result += idx[r] * m_Strides[r];
+            }
+            return result;
+        }
+
+        const size_t mask = (size_t(1) << m_TileShift) - 1;
+        const size_t row = idx[Rank - 2];
+        const size_t col = idx[Rank - 1];
+        const size_t tile = (row >> m_TileShift) * m_TilesPerRow + (col >> m_TileShift);
+        size_t result = (((tile << m_TileShift) + (row & mask)) << m_TileShift) + (col & mask);
+
+        // leading dimensions index whole (padded) planes
+        const size_t plane = m_TilesPerRow * round_up(m_Extents[Rank - 2], size_t(1) << m_TileShift) << m_TileShift;
+        size_t planes = 0;
+        for (size_t r = 0; r + 2 < Rank; ++r) {
+            planes = planes * m_Extents[r] + idx[r];
+        }
+        return result + planes * plane;
+    }
+
+    // element access without bounds checks (hot loops)
+    template <typename... Idx>
+    T& operator()(Idx... idx) {
+        static_assert(sizeof...(Idx) == Rank, "one index per dimension");
+        return data_handle()[offset(Extents{ static_cast<size_t>(idx)... })];
+    }
+
+    template <typename... Idx>
+    const T& operator()(Idx... idx) const {
+        static_assert(sizeof...(Idx) == Rank, "one index per dimension");
+        return data_handle()[offset(Extents{ static_cast<size_t>(idx)... })];
+    }
+
+    // element access with bounds checks
+    T& at(const Extents& idx) {
+        check(idx);
+        return data_handle()[offset(idx)];
+    }
+
+    const T& at(const Extents& idx) const {
+        check(idx);
+        return data_handle()[offset(idx)];
+    }
+
+    // mdspan-style accessors
+    static constexpr size_t rank() { return Rank; }
+    size_t extent(size_t r) const { return m_Extents[r]; }
+    const Extents& extents() const { return m_Extents; }
+    NdLayout layout() const { return m_Layout; }
+    bool is_strided() const { return m_Layout != NdLayout::Tiled; }
+    size_t tile() const { return m_Layout == NdLayout::Tiled ? size_t(1) << m_TileShift : 0; }
+
+    size_t stride(size_t r) const {
+        if (!is_strided()) {
+            throw std::logic_error("Tiled layout has no strides");
+        }
+        return m_Strides[r];
+    }
+
+    // number of element slots including padding
+    size_t required_span_size() const { return m_Span; }
+
+    // number of logical elements
+    size_t size() const {
+        size_t count = 1;
+        for (size_t r = 0; r < Rank; ++r) {
+            count *= m_Extents[r];
+        }
+        return count;
+    }
+
+    T* data_handle() { return m_Storage.data() + m_Offset; }
+    const T* data_handle() const { return m_Storage.data() + m_Offset; }
+
+    // Visit the array in blocks of at most 'block' elements per dimension.
+    // fn(lo, hi) gets the inclusive lower and exclusive upper index of each block.
+    // Blocks are visited with the last dimension fastest, which keeps stencils and
+    // copies inside a cache-sized working set.
+    template <typename F>
+    void for_each_block(size_t block, F fn) const {
+        if (block == 0) {
+            throw std::invalid_argument("Block size must not be zero");
+        }
+        for (size_t r = 0; r < Rank; ++r) {
+            if (m_Extents[r] == 0) {
+                return;
+            }
+        }
+        Extents lo{};
+        for (;;) {
+            Extents hi;
+            for (size_t r = 0; r < Rank; ++r) {
+                hi[r] = lo[r] + block < m_Extents[r] ? lo[r] + block : m_Extents[r];
+            }
+            fn(static_cast<const Extents&>(lo), static_cast<const Extents&>(hi));
+
+            // advance the block odometer
+            size_t r = Rank;
+            while (r-- > 0) {
+                lo[r] += block;
+                if (lo[r] < m_Extents[r]) {
+                    break;
+                }
+                lo[r] = 0;
+            }
+            if (r == static_cast<size_t>(-1)) {
+                return;
+            }
+        }
+    }
+
+    // Blocked transpose of a matrix; the result has the same layout (and tile
+    // size, if tiled). Reading and writing block x block squares keeps both
+    // sides cache resident.
+    NdVector transposed(size_t block = 32) const requires (Rank == 2) {
+        NdVector result(Extents{ m_Extents[1], m_Extents[0] }, m_Layout, m_Layout == NdLayout::Tiled ? tile() : 16);
+        for_each_block(block, [&](const Extents& lo, const Extents& hi) {
+            for (size_t i = lo[0]; i < hi[0]; ++i) {
+                for (size_t j = lo[1]; j < hi[1]; ++j) {
+                    result(j, i) = (*this)(i, j);
+                }
+            }
+        });
+        return result;
+    }
+
+private:
+    void check(const Extents& idx) const {
+        for (size_t r = 0; r < Rank; ++r) {
+            if (idx[r] >= m_Extents[r]) {
+                throw std::out_of_range("Index out of range");
+            }
+        }
+    }
+};
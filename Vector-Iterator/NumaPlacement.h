@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "SimpelVector.h"
+#include "Parallel.h"
+
+// NUMA placement for SimpelVector buffers.
+// Build with SIMPEL_USE_LIBNUMA defined (and link -lnuma) to get real placement
+// on Linux. Without it, or when the kernel reports a single node, every call
+// degrades to "one node, node 0": placement is a no-op and the partitioned
+// iteration is a plain parallel_for.
+#if defined(SIMPEL_USE_LIBNUMA)
+#include <numa.h>
+#include <numaif.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+enum class NumaPolicy {
+    Interleave, // pages round-robin over all nodes: even bandwidth for unpartitioned access
+    Partition,  // partition p of the buffer lives on node p * nodes / partitions (first touch by partition)
+    Bind        // the whole buffer lives on one node
+};
+
+// true if placement actually does something on this machine
+inline bool numa_multi_node() {
+#if defined(SIMPEL_USE_LIBNUMA)
+    return numa_available() >= 0 && numa_num_configured_nodes() > 1;
+#else
+    return false;
+#endif
+}
+
+inline int numa_node_count() {
+#if defined(SIMPEL_USE_LIBNUMA)
+    if (numa_available() >= 0) {
+        return numa_num_configured_nodes();
+    }
+#endif
+    return 1;
+}
+
+// node that currently backs the page containing 'p' (0 when unknown or not yet touched)
+inline int numa_node_of(const void* p) {
+#if defined(SIMPEL_USE_LIBNUMA)
+    if (numa_available() >= 0) {
+        int node = -1;
+        if (get_mempolicy(&node, nullptr, 0, const_cast<void*>(p), MPOL_F_NODE | MPOL_F_ADDR) == 0 && node >= 0) {
+            return node;
+        }
+    }
+#else
+    (void)p;
+#endif
+    return 0;
+}
+
+namespace numa_detail {
+
+#if defined(SIMPEL_USE_LIBNUMA)
+// apply a memory policy to the whole pages inside [begin, end) and migrate pages that already exist
+inline void bind_range(const void* begin, const void* end, int mode, int node) {
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t first = (reinterpret_cast<uintptr_t>(begin) + page - 1) & ~(page - 1);
+    const uintptr_t last = reinterpret_cast<uintptr_t>(end) & ~(page - 1);
+    if (first >= last) {
+        return; // smaller than a page: nothing worth moving
+    }
+
+    unsigned long mask = 0;
+    const int nodes = numa_num_configured_nodes();
+    for (int n = 0; n < nodes && n < static_cast<int>(sizeof(mask) * 8); ++n) {
+        if (mode == MPOL_INTERLEAVE || n == node) {
+            mask |= 1ul << n;
+        }
+    }
+    // best effort: a failing mbind only means the pages stay where they are
+    mbind(reinterpret_cast<void*>(first), last - first, mode, &mask, sizeof(mask) * 8, MPOL_MF_MOVE);
+}
+
+// Runs the current thread on the CPUs of one node for its lifetime and then
+// restores whatever CPU affinity the thread had before (the caller's own
+// pinning included, which numa_run_on_node(-1) would have thrown away).
+class NodeAffinity {
+private:
+    cpu_set_t m_Saved;
+    bool m_Restore;
+
+public:
+    explicit NodeAffinity(int node) : m_Restore(false) {
+        if (node < 0 || sched_getaffinity(0, sizeof(m_Saved), &m_Saved) != 0) {
+            return;
+        }
+        m_Restore = numa_run_on_node(node) == 0;
+    }
+
+    ~NodeAffinity() {
+        if (m_Restore) {
+            sched_setaffinity(0, sizeof(m_Saved), &m_Saved);
+        }
+    }
+
+    NodeAffinity(const NodeAffinity&) = delete;
+    NodeAffinity& operator=(const NodeAffinity&) = delete;
+};
+#endif
+
+} // namespace numa_detail
+
+// Place the buffer of 'vec' (its whole capacity) according to 'policy'.
+// Pages that were already touched are migrated; untouched pages (e.g. right
+// after reserve() of a trivial T) get the policy applied on first touch.
+// 'node' is used by Bind, 'partitions' by Partition (0 = one per pool thread).
+// The policy belongs to the current buffer only: once the vector reallocates
+// (growth past its capacity, reserve, shrink_to_fit, copies) the new buffer
+// is placed by plain first touch again. Reserve the final capacity before
+// placing, or call numa_place again after the vector has grown.
+template <typename T>
+void numa_place(SimpelVector<T>& vec, NumaPolicy policy, int node = 0, size_t partitions = 0) {
+#if defined(SIMPEL_USE_LIBNUMA)
+    if (!numa_multi_node() || vec.capacity() == 0) {
+        return;
+    }
+    const T* begin = vec.data();
+    const T* end = vec.data() + vec.capacity();
+    const int nodes = numa_num_configured_nodes();
+
+    switch (policy) {
+    case NumaPolicy::Interleave:
+        numa_detail::bind_range(begin, end, MPOL_INTERLEAVE, 0);
+        break;
+    case NumaPolicy::Bind:
+        numa_detail::bind_range(begin, end, MPOL_BIND, node);
+        break;
+    case NumaPolicy::Partition: {
+        if (partitions == 0) {
+            partitions = ThreadPool::instance().concurrency();
+        }
+        const size_t n = vec.capacity();
+        for (size_t p = 0; p < partitions; ++p) {
+            const int target = static_cast<int>(p * static_cast<size_t>(nodes) / partitions);
+            numa_detail::bind_range(begin + n * p / partitions, begin + n * (p + 1) / partitions, MPOL_BIND, target);
+        }
+        break;
+    }
+    }
+#else
+    (void)vec;
+    (void)policy;
+    (void)node;
+    (void)partitions;
+#endif
+}
+
+// Run fn(begin, end) over index ranges of 'vec' on the pool, with each chunk
+// executed on a CPU of the node that holds the chunk's first page. The pool has
+// no per-node workers: whichever thread claims a chunk (the caller included)
+// moves to that node for the chunk and gets its previous CPU affinity back
+// afterwards, so one migration per chunk is the price of node-local access.
+// On single-node machines this is parallel_for.
+template <typename T, typename F>
+void numa_parallel_for(SimpelVector<T>& vec, F fn, size_t grain = kParallelGrain) {
+#if defined(SIMPEL_USE_LIBNUMA)
+    if (numa_multi_node()) {
+        const size_t n = vec.size();
+        T* data = vec.data();
+        parallel_chunks(n, parallel_chunk_count(n, grain), [&](size_t, size_t begin, size_t end) {
+            if (begin == end) {
+                return;
+            }
+            // restores the thread's affinity even if fn throws
+            numa_detail::NodeAffinity pin(numa_node_of(data + begin));
+            fn(begin, end);
+        });
+        return;
+    }
+#endif
+    parallel_for(vec.size(), fn, grain);
+}
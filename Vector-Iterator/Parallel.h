@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Shared worker pool for the parallel kernels.
+// run(count, fn) calls fn(0) .. fn(count - 1) spread over the workers and the
+// calling thread, and returns when all calls finished. The caller claims chunks
+// of its own job too, so run() may be nested inside a chunk without deadlocking.
+// The first exception thrown by a chunk is rethrown from run().
+class ThreadPool {
+private:
+    struct Job {
+        const std::function<void(size_t)>* fn;
+        size_t count;
+        std::atomic<size_t> next{0};     // next chunk index to claim
+        std::atomic<size_t> finished{0}; // chunks done
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+
+    std::vector<std::thread> m_Workers;
+    std::deque<std::shared_ptr<Job>> m_Jobs;
+    std::mutex m_Mutex;
+    std::condition_variable m_Wake;
+    bool m_Stop;
+
+    // claim and run chunks of 'job' until none are left
+    static void work_on(Job& job) {
+        for (;;) {
+            const size_t index = job.next.fetch_add(1);
+            if (index >= job.count) {
+                return;
+            }
+            try {
+                (*job.fn)(index);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(job.mutex);
+                if (!job.error) {
+                    job.error = std::current_exception();
+                }
+            }
+            if (job.finished.fetch_add(1) + 1 == job.count) {
+                std::lock_guard<std::mutex> lock(job.mutex);
+                job.done.notify_all();
+            }
+        }
+    }
+
+    void worker_loop() {
+        for (;;) {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Wake.wait(lock, [this]() { return m_Stop || !m_Jobs.empty(); });
+                if (m_Stop) {
+                    return;
+                }
+                job = m_Jobs.front();
+                // every chunk is claimed: nobody else needs to see this job
+                if (job->next.load() >= job->count) {
+                    m_Jobs.pop_front();
+                    continue;
+                }
+            }
+            work_on(*job);
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t threads) : m_Stop(false) {
+        for (size_t i = 0; i < threads; ++i) {
+            m_Workers.emplace_back([this]() { worker_loop(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+        }
+        m_Wake.notify_all();
+        for (auto& worker : m_Workers) {
+            worker.join();
+        }
+    }
+
+    // process-wide pool: one worker per hardware thread besides the caller
+    static ThreadPool& instance() {
+        static ThreadPool pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+        return pool;
+    }
+
+    // number of threads that can work on a job at once (workers + caller)
+    size_t concurrency() const { return m_Workers.size() + 1; }
+
+    void run(size_t count, const std::function<void(size_t)>& fn) {
+        if (count == 0) {
+            return;
+        }
+        if (count == 1 || m_Workers.empty()) {
+            for (size_t i = 0; i < count; ++i) {
+                fn(i);
+            }
+            return;
+        }
+
+        auto job = std::make_shared<Job>();
+        job->fn = &fn;
+        job->count = count;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Jobs.push_back(job);
+        }
+        m_Wake.notify_all();
+
+        work_on(*job);
+        {
+            std::unique_lock<std::mutex> lock(job->mutex);
+            job->done.wait(lock, [&job]() { return job->finished.load() == job->count; });
+        }
+        if (job->error) {
+            std::rethrow_exception(job->error);
+        }
+    }
+};
+
+// Below this many elements the kernels stay on the calling thread.
+constexpr size_t kParallelGrain = size_t(1) << 15;
+
+// Split [0, n) into 'chunks' contiguous ranges and run fn(chunk, begin, end)
+// for each of them on the pool. Chunk boundaries are deterministic, so callers
+// can keep per-chunk state (e.g. private histograms) in an array indexed by chunk.
+template <typename F>
+void parallel_chunks(size_t n, size_t chunks, F fn) {
+    if (chunks == 0) {
+        chunks = 1;
+    }
+    const std::function<void(size_t)> chunk_fn = [&](size_t chunk) {
+        const size_t begin = n * chunk / chunks;
+        const size_t end = n * (chunk + 1) / chunks;
+        fn(chunk, begin, end);
+    };
+    ThreadPool::instance().run(chunks, chunk_fn);
+}
+
+// number of chunks to split n elements into: one per pool thread, none smaller than 'grain'
+inline size_t parallel_chunk_count(size_t n, size_t grain = kParallelGrain) {
+    const size_t by_size = grain == 0 ? n : n / grain;
+    const size_t threads = ThreadPool::instance().concurrency();
+    const size_t chunks = by_size < threads ? by_size : threads;
+    return chunks == 0 ? 1 : chunks;
+}
+
+// Run fn(begin, end) over [0, n), in parallel once n is large enough.
+template <typename F>
+void parallel_for(size_t n, F fn, size_t grain = kParallelGrain) {
+    const size_t chunks = parallel_chunk_count(n, grain);
+    if (chunks == 1) {
+        fn(size_t(0), n);
+        return;
+    }
+    parallel_chunks(n, chunks, [&](size_t, size_t begin, size_t end) { fn(begin, end); });
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+// Compile-time CPU feature detection for the SIMD kernels.
+// Everything is decided by the compiler flags (/arch:AVX2, -mavx2, ...); each
+// kernel keeps a scalar path, so a plain build still works everywhere.
+
+#if defined(__AVX512F__)
+#define SIMPEL_HAS_AVX512 1
+#endif
+
+// conflict detection (vpconflict); part of every AVX-512 CPU so far, but a separate flag
+#if defined(SIMPEL_HAS_AVX512) && defined(__AVX512CD__)
+#define SIMPEL_HAS_AVX512CD 1
+#endif
+
+#if defined(__AVX2__)
+#define SIMPEL_HAS_AVX2 1
+#endif
+
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define SIMPEL_HAS_SSE41 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMPEL_HAS_SSE2 1
+#endif
+
+#if defined(SIMPEL_HAS_SSE2)
+#include <immintrin.h>
+#endif
+
+// SIMPEL_PREFETCH(address): hint that 'address' will be read soon
+#if defined(SIMPEL_HAS_SSE2)
+#define SIMPEL_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#elif defined(__GNUC__)
+#define SIMPEL_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define SIMPEL_PREFETCH(address) ((void)(address))
+#endif
+
+// SIMPEL_PREFETCH_NTA(address): like SIMPEL_PREFETCH, for data read once; keeps
+// it out of the outer cache levels as far as the CPU allows
+#if defined(SIMPEL_HAS_SSE2)
+#define SIMPEL_PREFETCH_NTA(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_NTA)
+#elif defined(__GNUC__)
+#define SIMPEL_PREFETCH_NTA(address) __builtin_prefetch(address, 0, 0)
+#else
+#define SIMPEL_PREFETCH_NTA(address) ((void)(address))
+#endif
+
+// SIMPEL_STORE_FENCE(): make earlier non-temporal (streaming) stores globally
+// visible before any later store; needed before handing their data to another thread
+#if defined(SIMPEL_HAS_SSE2)
+#define SIMPEL_STORE_FENCE() _mm_sfence()
+#else
+#define SIMPEL_STORE_FENCE() ((void)0)
+#endif
+
+// distance (in elements) at which the gather/scatter loops prefetch ahead
+constexpr unsigned kPrefetchDistance = 16;
@@ -0,0 +1,338 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "SimpelVector.h"
+#include "Parallel.h"
+#include "Platform.h"
+
+// Prefix sums over SimpelVectors: parallel inclusive / exclusive scans, plus
+// a Fenwick tree and a segment tree for data that keeps changing.
+//
+// The scans work in two passes over the pool (reduce-then-scan): every chunk
+// first sums its elements, the chunk totals are scanned on the caller, then
+// every chunk scans its elements again starting from its total's prefix.
+// Input and output may be the same buffer. Within a chunk, 4- and 8-byte
+// integers are scanned four at a time in SIMD registers (log-step shifts);
+// other types use the scalar loop. Integer sums wrap like the scalar loop.
+
+namespace scan_detail {
+
+// sum of in[begin, end)
+template <typename T>
+T chunk_sum(const T* in, size_t begin, size_t end) {
+    T total = T();
+    size_t i = begin;
+#if defined(SIMPEL_HAS_AVX2)
+    if constexpr (std::is_integral_v<T> && (sizeof(T) == 8 || sizeof(T) == 4)) {
+        __m256i acc = _mm256_setzero_si256();
+        constexpr size_t lanes = 32 / sizeof(T);
+        for (; i + lanes <= end; i += lanes) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            acc = sizeof(T) == 8 ? _mm256_add_epi64(acc, block) : _mm256_add_epi32(acc, block);
+        }
+        alignas(32) T parts[lanes];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(parts), acc);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            total += parts[lane];
+        }
+    }
+#endif
+    for (; i < end; ++i) {
+        total += in[i];
+    }
+    return total;
+}
+
+// out[i] = carry + in[begin] + ... + in[i] (Inclusive) or without in[i] (exclusive)
+template <bool Inclusive, typename T>
+void chunk_scan(const T* in, T* out, size_t begin, size_t end, T carry) {
+    size_t i = begin;
+#if defined(SIMPEL_HAS_AVX2)
+    if constexpr (std::is_integral_v<T> && sizeof(T) == 8) {
+        // four lanes: add the block shifted up by one lane, then by two
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i running = _mm256_set1_epi64x(static_cast<long long>(carry));
+        for (; i + 4 <= end; i += 4) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            __m256i x = _mm256_add_epi64(block, _mm256_blend_epi32(_mm256_permute4x64_epi64(block, 0x90), zero, 0x03));
+            x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, 0x40), zero, 0x0F));
+            x = _mm256_add_epi64(x, running);
+            const __m256i result = Inclusive ? x : _mm256_sub_epi64(x, block);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), result);
+            running = _mm256_permute4x64_epi64(x, 0xFF);
+        }
+        carry = static_cast<T>(_mm256_extract_epi64(running, 0));
+    }
+#endif
+#if defined(SIMPEL_HAS_SSE2)
+    if constexpr (std::is_integral_v<T> && sizeof(T) == 4) {
+        __m128i running = _mm_set1_epi32(static_cast<int>(carry));
+        for (; i + 4 <= end; i += 4) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            __m128i x = _mm_add_epi32(block, _mm_slli_si128(block, 4));
+            x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+            x = _mm_add_epi32(x, running);
+            const __m128i result = Inclusive ? x : _mm_sub_epi32(x, block);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), result);
+            running = _mm_shuffle_epi32(x, 0xFF);
+        }
+        carry = static_cast<T>(_mm_cvtsi128_si32(running));
+    }
+#endif
+    for (; i < end; ++i) {
+        const T value = in[i];
+        if constexpr (Inclusive) {
+            carry += value;
+            out[i] = carry;
+        } else {
+            out[i] = carry;
+            carry += value;
+        }
+    }
+}
+
+template <bool Inclusive, typename T>
+void scan(const T* in, T* out, size_t n, T init) {
+    const size_t chunks = parallel_chunk_count(n);
+    if (chunks == 1) {
+        chunk_scan<Inclusive>(in, out, 0, n, init);
+        return;
+    }
+    SimpelVector<T> carries;
+    carries.resize(chunks);
+    T* carry = carries.data();
+    parallel_chunks(n, chunks, [&](size_t chunk, size_t begin, size_t end) {
+        carry[chunk] = chunk_sum(in, begin, end);
+    });
+    T running = init;
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        const T total = carry[chunk];
+        carry[chunk] = running;
+        running += total;
+    }
+    parallel_chunks(n, chunks, [&](size_t chunk, size_t begin, size_t end) {
+        chunk_scan<Inclusive>(in, out, begin, end, carry[chunk]);
+    });
+}
+
+} // namespace scan_detail
+
+// inclusive_scan: result[i] = values[0] + ... + values[i]
+template <typename T>
+SimpelVector<T> inclusive_scan(const SimpelVector<T>& values) {
+    SimpelVector<T> result;
+    result.resize(values.size());
+    scan_detail::scan<true>(values.data(), result.data(), values.size(), T());
+    return result;
+}
+
+// exclusive_scan: result[i] = init + values[0] + ... + values[i - 1]
+template <typename T>
+SimpelVector<T> exclusive_scan(const SimpelVector<T>& values, const T& init = T()) {
+    SimpelVector<T> result;
+    result.resize(values.size());
+    scan_detail::scan<false>(values.data(), result.data(), values.size(), init);
+    return result;
+}
+
+// Variants writing into 'out' (resized to match), so repeated scans reuse its
+// buffer instead of allocating a new one each time.
+template <typename T>
+void inclusive_scan(const SimpelVector<T>& values, SimpelVector<T>& out) {
+    out.resize(values.size());
+    scan_detail::scan<true>(values.data(), out.data(), values.size(), T());
+}
+
+template <typename T>
+void exclusive_scan(const SimpelVector<T>& values, SimpelVector<T>& out, const T& init = T()) {
+    out.resize(values.size());
+    scan_detail::scan<false>(values.data(), out.data(), values.size(), init);
+}
+
+// in-place variants
+template <typename T>
+void inclusive_scan_in_place(SimpelVector<T>& values) {
+    scan_detail::scan<true>(values.data(), values.data(), values.size(), T());
+}
+
+template <typename T>
+void exclusive_scan_in_place(SimpelVector<T>& values, const T& init = T()) {
+    scan_detail::scan<false>(values.data(), values.data(), values.size(), init);
+}
+
+// Fenwick (binary indexed) tree: point updates and prefix sums in O(log n),
+// stored as one SimpelVector of n partial sums (node i, 1-based, covers the
+// lowbit(i) elements ending at i). T needs + and -, e.g. integers or doubles.
+template <typename T>
+class FenwickTree {
+private:
+    SimpelVector<T> m_Tree; // 1-based: m_Tree[0] is unused
+
+public:
+    FenwickTree() { m_Tree.push_back(T()); }
+
+    explicit FenwickTree(size_t size) { m_Tree.resize(size + 1); }
+
+    // O(n) build: every node passes its sum on to its parent once
+    explicit FenwickTree(const SimpelVector<T>& values) {
+        const size_t n = values.size();
+        m_Tree.resize(n + 1);
+        T* tree = m_Tree.data();
+        for (size_t i = 1; i <= n; ++i) {
+            tree[i] += values.data()[i - 1];
+            const size_t parent = i + (i & (0 - i));
+            if (parent <= n) {
+                tree[parent] += tree[i];
+            }
+        }
+    }
+
+    // element 'index' += delta
+    void add(size_t index, const T& delta) {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        T* tree = m_Tree.data();
+        const size_t n = size();
+        for (size_t i = index + 1; i <= n; i += i & (0 - i)) {
+            tree[i] += delta;
+        }
+    }
+
+    // sum of the first 'count' elements
+    T prefix_sum(size_t count) const {
+        if (count > size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        const T* tree = m_Tree.data();
+        T sum = T();
+        for (size_t i = count; i > 0; i &= i - 1) {
+            sum += tree[i];
+        }
+        return sum;
+    }
+
+    // sum of elements [first, last)
+    T range_sum(size_t first, size_t last) const {
+        if (first > last) {
+            throw std::invalid_argument("Range start after range end");
+        }
+        return prefix_sum(last) - prefix_sum(first);
+    }
+
+    T value(size_t index) const { return range_sum(index, index + 1); }
+
+    void set(size_t index, const T& value) { add(index, value - this->value(index)); }
+
+    // Smallest count with prefix_sum(count) >= target, size() + 1 if there is
+    // none; needs non-negative elements. Descends by powers of two, O(log n).
+    size_t lower_bound(T target) const {
+        if (!(T() < target)) {
+            return 0;
+        }
+        const T* tree = m_Tree.data();
+        const size_t n = size();
+        size_t position = 0;
+        size_t step = 1;
+        while (step <= n / 2) {
+            step <<= 1;
+        }
+        for (; step > 0; step >>= 1) {
+            if (position + step <= n && tree[position + step] < target) {
+                position += step;
+                target -= tree[position];
+            }
+        }
+        return position + 1;
+    }
+
+    // accessors
+    size_t size() const { return m_Tree.size() - 1; }
+    bool empty() const { return size() == 0; }
+};
+
+// Segment tree over an associative Op with identity element (sum by default;
+// e.g. std::min-like functors for range minimum): point assignment and range
+// queries in O(log n). Bottom-up layout in one SimpelVector of 2n nodes, the
+// leaves in [n, 2n), node i combining 2i and 2i + 1. Op need not commute.
+template <typename T, typename Op = std::plus<T>>
+class SegmentTree {
+private:
+    SimpelVector<T> m_Nodes;
+    size_t m_Size;
+    T m_Identity;
+    Op m_Op;
+
+public:
+    explicit SegmentTree(size_t size = 0, const T& identity = T(), Op op = Op())
+        : m_Size(size), m_Identity(identity), m_Op(op) {
+        m_Nodes.resize(2 * size, identity);
+    }
+
+    SegmentTree(const SimpelVector<T>& values, const T& identity = T(), Op op = Op())
+        : m_Size(values.size()), m_Identity(identity), m_Op(op) {
+        m_Nodes.resize(2 * m_Size, identity);
+        T* nodes = m_Nodes.data();
+        for (size_t i = 0; i < m_Size; ++i) {
+            nodes[m_Size + i] = values.data()[i];
+        }
+        for (size_t i = m_Size; i-- > 1;) {
+            nodes[i] = m_Op(nodes[2 * i], nodes[2 * i + 1]);
+        }
+    }
+
+    // element 'index' = value, then recombine its ancestors
+    void set(size_t index, const T& value) {
+        if (index >= m_Size) {
+            throw std::out_of_range("Index out of range");
+        }
+        T* nodes = m_Nodes.data();
+        size_t i = index + m_Size;
+        nodes[i] = value;
+        for (i >>= 1; i > 0; i >>= 1) {
+            nodes[i] = m_Op(nodes[2 * i], nodes[2 * i + 1]);
+        }
+    }
+
+    // element 'index' = element 'index' op delta (add for sum trees)
+    void apply(size_t index, const T& delta) { set(index, m_Op(value(index), delta)); }
+
+    const T& value(size_t index) const {
+        if (index >= m_Size) {
+            throw std::out_of_range("Index out of range");
+        }
+        return m_Nodes.data()[index + m_Size];
+    }
+
+    // values[first] op ... op values[last - 1], the identity for an empty range
+    T query(size_t first, size_t last) const {
+        if (first > last) {
+            throw std::invalid_argument("Range start after range end");
+        }
+        if (last > m_Size) {
+            throw std::out_of_range("Index out of range");
+        }
+        const T* nodes = m_Nodes.data();
+        T left = m_Identity;
+        T right = m_Identity;
+        for (size_t l = first + m_Size, r = last + m_Size; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) {
+                left = m_Op(left, nodes[l++]);
+            }
+            if (r & 1) {
+                right = m_Op(nodes[--r], right);
+            }
+        }
+        return m_Op(left, right);
+    }
+
+    // accessors
+    size_t size() const { return m_Size; }
+    bool empty() const { return m_Size == 0; }
+};
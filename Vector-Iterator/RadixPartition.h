@@ -0,0 +1,355 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "SimpelVector.h"
+#include "Parallel.h"
+#include "Platform.h"
+#include "StreamingCopy.h"
+
+// Radix partitioning of (key, payload) columns into 2^bits cache-sized
+// partitions by the top bits of a key hash, and a partitioned hash join on top.
+//
+// Every pass is a parallel histogram + scatter: each chunk counts its
+// partitions, a partition-major prefix sum gives every (partition, chunk) its
+// own output range, and each chunk scatters into its ranges. The fan-out of
+// one pass is limited to 2^kMaxPassBits so the scatter's write streams stay
+// within the cache and TLB; more bits take a second pass that splits every
+// first-pass partition on its own.
+//
+// The scatter goes through software write-combining buffers: each partition
+// collects its next elements in a cache-line buffer mirroring the output line
+// they belong to, and a full line is written at once with non-temporal stores,
+// so the output neither has to be read in (no read-for-ownership) nor evicts
+// the buffers and input from the cache. Lines shared with a neighbouring
+// range are written with plain stores.
+
+// Result of radix_partition: the input rows regrouped so that partition p
+// occupies [offsets[p], offsets[p + 1]) of keys and payloads.
+template <typename Key, typename Payload>
+struct RadixPartitions {
+    SimpelVector<Key> keys;
+    SimpelVector<Payload> payloads;
+    SimpelVector<size_t> offsets;
+
+    size_t partition_count() const { return offsets.size() - 1; }
+};
+
+namespace partition_detail {
+
+constexpr unsigned kMaxPassBits = 11;
+
+template <typename Key>
+uint64_t radix_hash(const Key& key) {
+    static_assert(std::is_integral_v<Key>, "keys must be integers");
+    uint64_t h = static_cast<uint64_t>(key);
+    h ^= h >> 32;
+    return h * 0x9E3779B97F4A7C15ull;
+}
+
+// Write-combining buffers for one output column of one scatter range.
+// Element 'index' of the output lives in slot (index + phase) % kPerLine of
+// its line, so a buffer fills up exactly when its output line is complete.
+// Types that do not tile a cache line are stored directly.
+template <typename T>
+class LineBuffers {
+private:
+    static constexpr bool kCombine = std::is_trivially_copyable_v<T> && sizeof(T) <= kCacheLine && kCacheLine % sizeof(T) == 0;
+    static constexpr size_t kPerLine = kCombine ? kCacheLine / sizeof(T) : 1;
+
+    struct alignas(kCacheLine) Line {
+        T slots[kPerLine];
+    };
+
+    T* m_Out;
+    const size_t* m_Begin; // first output index of each partition's range
+    SimpelVector<Line> m_Lines;
+    size_t m_Phase;
+    bool m_Combine;
+
+    // write the buffered slots [first, filled) of the line ending at 'end'
+    // (slots before the range's start belong to someone else, or lie before m_Out)
+    void flush(size_t part, size_t end, size_t filled) {
+        const size_t first = m_Begin[part] + filled > end ? m_Begin[part] + filled - end : 0;
+        const Line& line = m_Lines.data()[part];
+        if (first == 0 && filled == kPerLine) {
+            stream_line(m_Out + (end - filled), line.slots);
+        } else {
+            std::memcpy(m_Out + (end - filled + first), line.slots + first, (filled - first) * sizeof(T));
+        }
+    }
+
+public:
+    LineBuffers(T* out, const size_t* begin, size_t parts) : m_Out(out), m_Begin(begin), m_Phase(0), m_Combine(false) {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(out);
+        if (kCombine && address % sizeof(T) == 0) {
+            m_Combine = true;
+            m_Phase = (address % kCacheLine) / sizeof(T);
+            m_Lines.resize(parts);
+        }
+    }
+
+    void put(size_t part, size_t index, const T& value) {
+        if (!m_Combine) {
+            m_Out[index] = value;
+            return;
+        }
+        const size_t slot = (index + m_Phase) % kPerLine;
+        m_Lines.data()[part].slots[slot] = value;
+        if (slot == kPerLine - 1) {
+            flush(part, index + 1, kPerLine);
+        }
+    }
+
+    // write out the partial lines; 'end' holds each partition's next index
+    void finish(const size_t* end, size_t parts) {
+        if (!m_Combine) {
+            return;
+        }
+        for (size_t part = 0; part < parts; ++part) {
+            const size_t filled = (end[part] + m_Phase) % kPerLine;
+            if (end[part] > m_Begin[part] && filled != 0) {
+                flush(part, end[part], filled);
+            }
+        }
+        SIMPEL_STORE_FENCE();
+    }
+};
+
+// scatter rows [begin, end) to the partitions' next positions in 'cursor'
+template <typename Key, typename Payload, typename DigitOf>
+void scatter_range(const Key* keys, const Payload* payloads, size_t begin, size_t end, size_t parts, DigitOf digit_of,
+                   size_t* cursor, Key* out_keys, Payload* out_payloads) {
+    SimpelVector<size_t> starts;
+    starts.resize(parts);
+    std::memcpy(starts.data(), cursor, parts * sizeof(size_t));
+    LineBuffers<Key> key_lines(out_keys, starts.data(), parts);
+    LineBuffers<Payload> payload_lines(out_payloads, starts.data(), parts);
+    for (size_t i = begin; i < end; ++i) {
+        const size_t part = digit_of(keys[i]);
+        const size_t at = cursor[part]++;
+        key_lines.put(part, at, keys[i]);
+        payload_lines.put(part, at, payloads[i]);
+    }
+    key_lines.finish(cursor, parts);
+    payload_lines.finish(cursor, parts);
+}
+
+// One pass over rows [begin, end), split into 'chunks' on the pool (1 keeps it
+// on the calling thread). Partition p starts at offsets[p]; the caller sets
+// the end (offsets[parts]), which may be shared with a neighbouring pass.
+template <typename Key, typename Payload, typename DigitOf>
+void partition_pass(const Key* keys, const Payload* payloads, size_t begin, size_t end, size_t parts, DigitOf digit_of,
+                    size_t chunks, Key* out_keys, Payload* out_payloads, size_t* offsets) {
+    const size_t n = end - begin;
+    SimpelVector<size_t> cursors;
+    cursors.resize(chunks * parts);
+    const auto count = [&](size_t chunk, size_t first, size_t last) {
+        size_t* histogram = cursors.data() + chunk * parts;
+        for (size_t i = begin + first; i < begin + last; ++i) {
+            ++histogram[digit_of(keys[i])];
+        }
+    };
+    const auto scatter = [&](size_t chunk, size_t first, size_t last) {
+        scatter_range(keys, payloads, begin + first, begin + last, parts, digit_of, cursors.data() + chunk * parts,
+                      out_keys, out_payloads);
+    };
+
+    if (chunks == 1) {
+        count(0, 0, n);
+    } else {
+        parallel_chunks(n, chunks, count);
+    }
+    size_t position = begin;
+    for (size_t part = 0; part < parts; ++part) {
+        offsets[part] = position;
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            size_t& cursor = cursors.data()[chunk * parts + part];
+            const size_t rows = cursor;
+            cursor = position;
+            position += rows;
+        }
+    }
+    if (chunks == 1) {
+        scatter(0, 0, n);
+    } else {
+        parallel_chunks(n, chunks, scatter);
+    }
+}
+
+} // namespace partition_detail
+
+// Partition (keys[i], payloads[i]) rows into 2^bits partitions by the top
+// 'bits' bits of a key hash: one pass up to kMaxPassBits bits, else two.
+template <typename Key, typename Payload>
+RadixPartitions<Key, Payload> radix_partition(const SimpelVector<Key>& keys, const SimpelVector<Payload>& payloads,
+                                              unsigned bits) {
+    using namespace partition_detail;
+    if (keys.size() != payloads.size()) {
+        throw std::invalid_argument("radix_partition needs one payload per key");
+    }
+    if (bits > 2 * kMaxPassBits) {
+        throw std::invalid_argument("Too many radix bits");
+    }
+    const size_t n = keys.size();
+    const size_t parts = size_t(1) << bits;
+    RadixPartitions<Key, Payload> result;
+    result.keys.resize(n);
+    result.payloads.resize(n);
+    result.offsets.resize(parts + 1);
+    if (bits == 0) {
+        std::copy(keys.data(), keys.data() + n, result.keys.data());
+        std::copy(payloads.data(), payloads.data() + n, result.payloads.data());
+        result.offsets.data()[1] = n;
+        return result;
+    }
+
+    // more bits than one pass can take: split them evenly over two passes
+    const unsigned first_bits = bits <= kMaxPassBits ? bits : (bits + 1) / 2;
+    const unsigned second_bits = bits - first_bits;
+    const auto first_digit = [first_bits](const Key& key) {
+        return static_cast<size_t>(radix_hash(key) >> (64 - first_bits));
+    };
+    result.offsets.data()[parts] = n;
+    if (second_bits == 0) {
+        partition_pass(keys.data(), payloads.data(), 0, n, parts, first_digit, parallel_chunk_count(n),
+                       result.keys.data(), result.payloads.data(), result.offsets.data());
+        return result;
+    }
+
+    // first pass into scratch columns, then every partition is split further on its own
+    SimpelVector<Key> scratch_keys;
+    scratch_keys.resize(n);
+    SimpelVector<Payload> scratch_payloads;
+    scratch_payloads.resize(n);
+    const size_t first_parts = size_t(1) << first_bits;
+    const size_t second_parts = size_t(1) << second_bits;
+    SimpelVector<size_t> first_offsets;
+    first_offsets.resize(first_parts + 1);
+    first_offsets.data()[first_parts] = n;
+    partition_pass(keys.data(), payloads.data(), 0, n, first_parts, first_digit, parallel_chunk_count(n),
+                   scratch_keys.data(), scratch_payloads.data(), first_offsets.data());
+
+    const auto second_digit = [bits, second_parts](const Key& key) {
+        return static_cast<size_t>(radix_hash(key) >> (64 - bits)) & (second_parts - 1);
+    };
+    parallel_for(first_parts, [&](size_t begin, size_t end) {
+        for (size_t part = begin; part < end; ++part) {
+            partition_pass(scratch_keys.data(), scratch_payloads.data(), first_offsets.data()[part],
+                           first_offsets.data()[part + 1], second_parts, second_digit, 1, result.keys.data(),
+                           result.payloads.data(), result.offsets.data() + part * second_parts);
+        }
+    }, 1);
+    return result;
+}
+
+// Row pairs of an equi-join: build_rows[i] and probe_rows[i] have equal keys.
+struct JoinPairs {
+    SimpelVector<uint32_t> build_rows;
+    SimpelVector<uint32_t> probe_rows;
+};
+
+// Radix-partitioned hash join of two key columns: both sides are partitioned
+// (row numbers as payload) until a build partition and its hash table fit in
+// the L2 cache, then every partition pair is joined on the pool with a chained
+// table over the build partition. All matching pairs are reported, duplicates
+// included, grouped by partition.
+template <typename Key>
+JoinPairs hash_join(const SimpelVector<Key>& build_keys, const SimpelVector<Key>& probe_keys) {
+    using namespace partition_detail;
+    constexpr uint32_t kNone = 0xFFFFFFFF;
+    if (build_keys.size() >= kNone || probe_keys.size() >= kNone) {
+        throw std::length_error("Too many rows for a hash join");
+    }
+    constexpr size_t kL2Bytes = size_t(256) << 10;
+    constexpr size_t kRowBytes = sizeof(Key) + 3 * sizeof(uint32_t); // key, row, table head, chain link
+    const size_t build_bytes = build_keys.size() * kRowBytes;
+    unsigned bits = build_bytes > kL2Bytes ? static_cast<unsigned>(std::bit_width((build_bytes - 1) / kL2Bytes)) : 0;
+    bits = bits < 2 * kMaxPassBits ? bits : 2 * kMaxPassBits;
+
+    const auto row_numbers = [](size_t n) {
+        SimpelVector<uint32_t> rows;
+        rows.resize(n);
+        parallel_for(n, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                rows.data()[i] = static_cast<uint32_t>(i);
+            }
+        });
+        return rows;
+    };
+    SimpelVector<uint32_t> build_rows = row_numbers(build_keys.size());
+    SimpelVector<uint32_t> probe_rows = row_numbers(probe_keys.size());
+    const RadixPartitions<Key, uint32_t> build = radix_partition(build_keys, build_rows, bits);
+    const RadixPartitions<Key, uint32_t> probe = radix_partition(probe_keys, probe_rows, bits);
+
+    // join the partition pairs, each task appending to its own output
+    const size_t parts = size_t(1) << bits;
+    const size_t tasks = parallel_chunk_count(parts, 1);
+    std::vector<JoinPairs> outputs(tasks); // constructed in place: never copied
+    parallel_chunks(parts, tasks, [&](size_t task, size_t begin, size_t end) {
+        JoinPairs& out = outputs[task];
+        // one match per probe row is exact for unique build keys (the common foreign-key join)
+        const size_t probes = probe.offsets.data()[end] - probe.offsets.data()[begin];
+        out.build_rows.reserve(probes);
+        out.probe_rows.reserve(probes);
+        SimpelVector<uint32_t> heads;
+        SimpelVector<uint32_t> next;
+        for (size_t part = begin; part < end; ++part) {
+            const size_t build_first = build.offsets.data()[part];
+            const size_t build_count = build.offsets.data()[part + 1] - build_first;
+            if (build_count == 0) {
+                continue;
+            }
+            const Key* keys = build.keys.data() + build_first;
+            // table index: hash bits just below the partition bits
+            const size_t mask = std::bit_ceil(build_count) - 1;
+            const auto slot_of = [&](const Key& key) { return static_cast<size_t>(radix_hash(key) << bits >> 32) & mask; };
+            heads.clear();
+            heads.resize(mask + 1, kNone);
+            next.resize(build_count);
+            for (size_t i = 0; i < build_count; ++i) {
+                const size_t slot = slot_of(keys[i]);
+                next.data()[i] = heads.data()[slot];
+                heads.data()[slot] = static_cast<uint32_t>(i);
+            }
+            for (size_t j = probe.offsets.data()[part]; j < probe.offsets.data()[part + 1]; ++j) {
+                const Key& key = probe.keys.data()[j];
+                for (uint32_t i = heads.data()[slot_of(key)]; i != kNone; i = next.data()[i]) {
+                    if (keys[i] == key) {
+                        out.build_rows.push_back(build.payloads.data()[build_first + i]);
+                        out.probe_rows.push_back(probe.payloads.data()[j]);
+                    }
+                }
+            }
+        }
+    });
+
+    JoinPairs result;
+    if (tasks == 1) {
+        result.build_rows.swap(outputs[0].build_rows);
+        result.probe_rows.swap(outputs[0].probe_rows);
+        return result;
+    }
+    size_t total = 0;
+    for (size_t task = 0; task < tasks; ++task) {
+        total += outputs[task].build_rows.size();
+    }
+    result.build_rows.resize(total);
+    result.probe_rows.resize(total);
+    size_t position = 0;
+    for (size_t task = 0; task < tasks; ++task) {
+        const JoinPairs& out = outputs[task];
+        const size_t count = out.build_rows.size();
+        std::memcpy(result.build_rows.data() + position, out.build_rows.data(), count * sizeof(uint32_t));
+        std::memcpy(result.probe_rows.data() + position, out.probe_rows.data(), count * sizeof(uint32_t));
+        position += count;
+    }
+    return result;
+}
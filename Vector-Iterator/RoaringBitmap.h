@@ -0,0 +1,866 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "SimpelVector.h"
+#include "Platform.h"
+
+// Compressed set of 32-bit integers (Roaring bitmap).
+// Values are split by their high 16 bits into chunks of 65536; every non-empty
+// chunk gets one container holding the low 16 bits in whichever form is smallest:
+//
+//   Array:  sorted uint16 values              (cardinality <= 4096)
+//   Bitmap: 1024 uint64 words, one bit each   (cardinality  > 4096)
+//   Run:    (start, length - 1) uint16 pairs  (after run_optimize(), for long runs)
+//
+// Set operations combine matching containers: bitmap/bitmap with AVX2 (or SSE2)
+// word operations, array/array intersections with an SSE2 all-against-all block
+// compare, everything else with merges or bit tests. Run containers are expanded
+// to an array or bitmap when an operation needs it.
+//
+// serialize()/deserialize() use the portable Roaring format (little endian,
+// cookies 12346/12347), so the bytes can be read by the other Roaring libraries.
+class RoaringBitmap {
+private:
+    static constexpr uint32_t kArrayLimit = 4096;  // largest array container
+    static constexpr size_t kBitmapWords = 1024;   // 65536 bits
+    static constexpr uint32_t kCookieNoRuns = 12346;
+    static constexpr uint32_t kCookie = 12347;
+    static constexpr size_t kNoOffsetThreshold = 4;
+
+    enum class Kind : uint8_t { Array, Bitmap, Run };
+    enum class BitOp { And, Or, AndNot };
+
+    struct Container {
+        Kind kind = Kind::Array;
+        uint32_t cardinality = 0;
+        SimpelVector<uint16_t> values; // Array: sorted values, Run: (start, length - 1) pairs
+        SimpelVector<uint64_t> bits;   // Bitmap: kBitmapWords words
+
+        Container() = default;
+
+        // copies go through append() so containers copy without the vector's logging
+        Container(const Container& other) { *this = other; }
+
+        Container(Container&& other) noexcept { swap(other); }
+
+        Container& operator=(const Container& other) {
+            if (this != &other) {
+                kind = other.kind;
+                cardinality = other.cardinality;
+                values.clear();
+                values.append(other.values.data(), other.values.size());
+                bits.clear();
+                bits.append(other.bits.data(), other.bits.size());
+            }
+            return *this;
+        }
+
+        Container& operator=(Container&& other) noexcept {
+            swap(other);
+            return *this;
+        }
+
+        void swap(Container& other) noexcept {
+            std::swap(kind, other.kind);
+            std::swap(cardinality, other.cardinality);
+            values.swap(other.values);
+            bits.swap(other.bits);
+        }
+
+        size_t runs() const { return values.size() / 2; }
+    };
+
+    SimpelVector<uint16_t> m_Keys;        // high 16 bits, strictly increasing
+    SimpelVector<Container> m_Containers; // one per key
+
+    // ---- container conversions ----------------------------------------------
+
+    static Container make_bitmap() {
+        Container c;
+        c.kind = Kind::Bitmap;
+        c.bits.resize(kBitmapWords, 0);
+        return c;
+    }
+
+    // bitmap -> array (cardinality must be <= kArrayLimit)
+    static Container bitmap_to_array(const Container& c) {
+        Container result;
+        result.values.reserve(c.cardinality);
+        const uint64_t* bits = c.bits.data();
+        for (size_t w = 0; w < kBitmapWords; ++w) {
+            for (uint64_t word = bits[w]; word; word &= word - 1) {
+                result.values.push_back(static_cast<uint16_t>(w * 64 + std::countr_zero(word)));
+            }
+        }
+        result.cardinality = c.cardinality;
+        return result;
+    }
+
+    static Container array_to_bitmap(const Container& c) {
+        Container result = make_bitmap();
+        uint64_t* bits = result.bits.data();
+        for (const auto& value : c.values) {
+            bits[value / 64] |= uint64_t(1) << (value % 64);
+        }
+        result.cardinality = c.cardinality;
+        return result;
+    }
+
+    // run -> array or bitmap, whichever the cardinality calls for
+    static Container run_to_plain(const Container& c) {
+        const uint16_t* runs = c.values.data();
+        if (c.cardinality <= kArrayLimit) {
+            Container result;
+            result.values.reserve(c.cardinality);
+            for (size_t r = 0; r < c.runs(); ++r) {
+                for (uint32_t v = runs[2 * r]; v <= uint32_t(runs[2 * r]) + runs[2 * r + 1]; ++v) {
+                    result.values.push_back(static_cast<uint16_t>(v));
+                }
+            }
+            result.cardinality = c.cardinality;
+            return result;
+        }
+        Container result = make_bitmap();
+        for (size_t r = 0; r < c.runs(); ++r) {
+            set_range(result.bits.data(), runs[2 * r], uint32_t(runs[2 * r]) + runs[2 * r + 1] + 1);
+        }
+        result.cardinality = c.cardinality;
+        return result;
+    }
+
+    // set bits [begin, end) of a bitmap container
+    static void set_range(uint64_t* bits, uint32_t begin, uint32_t end) {
+        while (begin < end) {
+            const uint32_t word = begin / 64;
+            const uint32_t last = end < (word + 1) * 64 ? end : (word + 1) * 64;
+            const uint32_t width = last - begin;
+            const uint64_t mask = width == 64 ? ~uint64_t(0) : ((uint64_t(1) << width) - 1) << (begin % 64);
+            bits[word] |= mask;
+            begin = last;
+        }
+    }
+
+    // the container itself, or its array/bitmap form in 'scratch' if it is a run container
+    static const Container& plain(const Container& c, Container& scratch) {
+        if (c.kind != Kind::Run) {
+            return c;
+        }
+        scratch = run_to_plain(c);
+        return scratch;
+    }
+
+    // keep the array/bitmap invariant after an operation changed the cardinality
+    static void normalize(Container& c) {
+        if (c.kind == Kind::Bitmap && c.cardinality <= kArrayLimit) {
+            c = bitmap_to_array(c);
+        } else if (c.kind == Kind::Array && c.cardinality > kArrayLimit) {
+            c = array_to_bitmap(c);
+        }
+    }
+
+    static bool container_contains(const Container& c, uint16_t low) {
+        if (c.kind == Kind::Bitmap) {
+            return (c.bits.data()[low / 64] >> (low % 64)) & 1;
+        }
+        if (c.kind == Kind::Array) {
+            const uint16_t* first = c.values.data();
+            const uint16_t* last = first + c.values.size();
+            const uint16_t* it = std::lower_bound(first, last, low);
+            return it != last && *it == low;
+        }
+        // last run starting at or before 'low'
+        const uint16_t* runs = c.values.data();
+        size_t lo = 0;
+        size_t hi = c.runs();
+        while (lo < hi) {
+            const size_t mid = (lo + hi) / 2;
+            if (runs[2 * mid] <= low) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo > 0 && low <= uint32_t(runs[2 * (lo - 1)]) + runs[2 * (lo - 1) + 1];
+    }
+
+    // ---- container kernels ---------------------------------------------------
+
+    // out = a op b over whole bitmaps; returns the cardinality of the result
+    template <BitOp Op>
+    static uint32_t bitmap_op(const uint64_t* a, const uint64_t* b, uint64_t* out) {
+        size_t w = 0;
+#if defined(SIMPEL_HAS_AVX2)
+        for (; w < kBitmapWords; w += 4) {
+            const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w));
+            const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + w));
+            __m256i result;
+            if constexpr (Op == BitOp::And) {
+                result = _mm256_and_si256(va, vb);
+            } else if constexpr (Op == BitOp::Or) {
+                result = _mm256_or_si256(va, vb);
+            } else {
+                result = _mm256_andnot_si256(vb, va);
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + w), result);
+        }
+#elif defined(SIMPEL_HAS_SSE2)
+        for (; w < kBitmapWords; w += 2) {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + w));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + w));
+            __m128i result;
+            if constexpr (Op == BitOp::And) {
+                result = _mm_and_si128(va, vb);
+            } else if constexpr (Op == BitOp::Or) {
+                result = _mm_or_si128(va, vb);
+            } else {
+                result = _mm_andnot_si128(vb, va);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + w), result);
+        }
+#endif
+        for (; w < kBitmapWords; ++w) {
+            if constexpr (Op == BitOp::And) {
+                out[w] = a[w] & b[w];
+            } else if constexpr (Op == BitOp::Or) {
+                out[w] = a[w] | b[w];
+            } else {
+                out[w] = a[w] & ~b[w];
+            }
+        }
+        uint32_t cardinality = 0;
+        for (w = 0; w < kBitmapWords; ++w) {
+            cardinality += static_cast<uint32_t>(std::popcount(out[w]));
+        }
+        return cardinality;
+    }
+
+    // Intersection of two sorted uint16 arrays into 'out' (room for min(na, nb)),
+    // returns the number written. With SSE2, blocks of 8 are compared
+    // all-against-all through 8 rotations of b's block; the block with the
+    // smaller last value is advanced, as in SparseVector::dot.
+    static size_t intersect_arrays(const uint16_t* a, size_t na, const uint16_t* b, size_t nb, uint16_t* out) {
+        size_t i = 0;
+        size_t j = 0;
+        size_t n = 0;
+#if defined(SIMPEL_HAS_SSE2)
+        while (i + 8 <= na && j + 8 <= nb) {
+            const __m128i block_a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i block_b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+            __m128i match = _mm_cmpeq_epi16(block_a, block_b);
+            for (int r = 1; r < 8; ++r) {
+                block_b = _mm_or_si128(_mm_srli_si128(block_b, 2), _mm_slli_si128(block_b, 14));
+                match = _mm_or_si128(match, _mm_cmpeq_epi16(block_a, block_b));
+            }
+            // two mask bits per 16-bit lane; a's lanes are emitted in order, so out stays sorted
+            for (unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(match)); mask; mask &= mask - 1) {
+                const unsigned bit = static_cast<unsigned>(std::countr_zero(mask));
+                if (bit % 2 == 0) {
+                    out[n++] = a[i + bit / 2];
+                }
+            }
+            const uint16_t last_a = a[i + 7];
+            const uint16_t last_b = b[j + 7];
+            i += last_a <= last_b ? 8 : 0;
+            j += last_b <= last_a ? 8 : 0;
+        }
+#endif
+        while (i < na && j < nb) {
+            if (a[i] < b[j]) {
+                ++i;
+            } else if (b[j] < a[i]) {
+                ++j;
+            } else {
+                out[n++] = a[i];
+                ++i;
+                ++j;
+            }
+        }
+        return n;
+    }
+
+    static Container intersect(const Container& x, const Container& y) {
+        Container sx;
+        Container sy;
+        const Container& a = plain(x, sx);
+        const Container& b = plain(y, sy);
+        Container result;
+        if (a.kind == Kind::Bitmap && b.kind == Kind::Bitmap) {
+            result = make_bitmap();
+            result.cardinality = bitmap_op<BitOp::And>(a.bits.data(), b.bits.data(), result.bits.data());
+            normalize(result);
+        } else if (a.kind == Kind::Array && b.kind == Kind::Array) {
+            result.values.resize(a.cardinality < b.cardinality ? a.cardinality : b.cardinality);
+            const size_t n = intersect_arrays(a.values.data(), a.values.size(), b.values.data(), b.values.size(), result.values.data());
+            result.values.resize(n);
+            result.cardinality = static_cast<uint32_t>(n);
+        } else {
+            // array & bitmap: keep the array values whose bit is set
+            const Container& array = a.kind == Kind::Array ? a : b;
+            const Container& bitmap = a.kind == Kind::Array ? b : a;
+            result.values.reserve(array.cardinality);
+            for (const auto& value : array.values) {
+                if ((bitmap.bits.data()[value / 64] >> (value % 64)) & 1) {
+                    result.values.push_back(value);
+                }
+            }
+            result.cardinality = static_cast<uint32_t>(result.values.size());
+        }
+        return result;
+    }
+
+    static Container unite(const Container& x, const Container& y) {
+        Container sx;
+        Container sy;
+        const Container& a = plain(x, sx);
+        const Container& b = plain(y, sy);
+        Container result;
+        if (a.kind == Kind::Bitmap && b.kind == Kind::Bitmap) {
+            result = make_bitmap();
+            result.cardinality = bitmap_op<BitOp::Or>(a.bits.data(), b.bits.data(), result.bits.data());
+        } else if (a.kind == Kind::Array && b.kind == Kind::Array) {
+            result.values.reserve(a.cardinality + b.cardinality);
+            const uint16_t* pa = a.values.data();
+            const uint16_t* pb = b.values.data();
+            size_t i = 0;
+            size_t j = 0;
+            while (i < a.values.size() || j < b.values.size()) {
+                if (j == b.values.size() || (i < a.values.size() && pa[i] < pb[j])) {
+                    result.values.push_back(pa[i++]);
+                } else if (i == a.values.size() || pb[j] < pa[i]) {
+                    result.values.push_back(pb[j++]);
+                } else {
+                    result.values.push_back(pa[i++]);
+                    ++j;
+                }
+            }
+            result.cardinality = static_cast<uint32_t>(result.values.size());
+            normalize(result);
+        } else {
+            // array | bitmap: set the array's bits in a copy of the bitmap
+            const Container& array = a.kind == Kind::Array ? a : b;
+            result = a.kind == Kind::Array ? b : a;
+            uint64_t* bits = result.bits.data();
+            for (const auto& value : array.values) {
+                const uint64_t bit = uint64_t(1) << (value % 64);
+                result.cardinality += (bits[value / 64] & bit) ? 0 : 1;
+                bits[value / 64] |= bit;
+            }
+        }
+        return result;
+    }
+
+    static Container subtract(const Container& x, const Container& y) {
+        Container sx;
+        Container sy;
+        const Container& a = plain(x, sx);
+        const Container& b = plain(y, sy);
+        Container result;
+        if (a.kind == Kind::Bitmap && b.kind == Kind::Bitmap) {
+            result = make_bitmap();
+            result.cardinality = bitmap_op<BitOp::AndNot>(a.bits.data(), b.bits.data(), result.bits.data());
+            normalize(result);
+        } else if (a.kind == Kind::Bitmap) {
+            // bitmap - array: clear the array's bits in a copy of the bitmap
+            result = a;
+            uint64_t* bits = result.bits.data();
+            for (const auto& value : b.values) {
+                const uint64_t bit = uint64_t(1) << (value % 64);
+                result.cardinality -= (bits[value / 64] & bit) ? 1 : 0;
+                bits[value / 64] &= ~bit;
+            }
+            normalize(result);
+        } else {
+            // array - (array or bitmap): keep the values 'b' does not contain
+            result.values.reserve(a.cardinality);
+            const uint16_t* pb = b.values.data();
+            size_t j = 0;
+            for (const auto& value : a.values) {
+                bool found;
+                if (b.kind == Kind::Bitmap) {
+                    found = (b.bits.data()[value / 64] >> (value % 64)) & 1;
+                } else {
+                    while (j < b.values.size() && pb[j] < value) {
+                        ++j;
+                    }
+                    found = j < b.values.size() && pb[j] == value;
+                }
+                if (!found) {
+                    result.values.push_back(value);
+                }
+            }
+            result.cardinality = static_cast<uint32_t>(result.values.size());
+        }
+        return result;
+    }
+
+    // Merge two bitmaps key by key. Containers whose key only one side has are
+    // copied when keep_a / keep_b says so; matching ones are combined by 'op'.
+    template <typename Op>
+    static RoaringBitmap merge(const RoaringBitmap& a, const RoaringBitmap& b, bool keep_a, bool keep_b, Op op) {
+        RoaringBitmap result;
+        size_t i = 0;
+        size_t j = 0;
+        const size_t na = a.m_Keys.size();
+        const size_t nb = b.m_Keys.size();
+        while (i < na || j < nb) {
+            const bool has_a = i < na;
+            const bool has_b = j < nb;
+            if (has_a && (!has_b || a.m_Keys.data()[i] < b.m_Keys.data()[j])) {
+                if (keep_a) {
+                    result.append_container(a.m_Keys.data()[i], Container(a.m_Containers.data()[i]));
+                }
+                ++i;
+            } else if (has_b && (!has_a || b.m_Keys.data()[j] < a.m_Keys.data()[i])) {
+                if (keep_b) {
+                    result.append_container(b.m_Keys.data()[j], Container(b.m_Containers.data()[j]));
+                }
+                ++j;
+            } else {
+                Container combined = op(a.m_Containers.data()[i], b.m_Containers.data()[j]);
+                if (combined.cardinality > 0) {
+                    result.append_container(a.m_Keys.data()[i], std::move(combined));
+                }
+                ++i;
+                ++j;
+            }
+        }
+        return result;
+    }
+
+    void append_container(uint16_t key, Container&& container) {
+        m_Keys.push_back(key);
+        m_Containers.push_back(std::move(container));
+    }
+
+    // index of 'key' in m_Keys, or where it would be inserted
+    size_t find_key(uint16_t key) const {
+        const uint16_t* first = m_Keys.data();
+        return static_cast<size_t>(std::lower_bound(first, first + m_Keys.size(), key) - first);
+    }
+
+    bool has_key(size_t index, uint16_t key) const {
+        return index < m_Keys.size() && m_Keys.data()[index] == key;
+    }
+
+    // ---- serialization helpers ------------------------------------------------
+
+    static void write_u16(SimpelVector<char>& out, uint16_t value) {
+        out.push_back(static_cast<char>(value & 0xFF));
+        out.push_back(static_cast<char>(value >> 8));
+    }
+
+    static void write_u32(SimpelVector<char>& out, uint32_t value) {
+        write_u16(out, static_cast<uint16_t>(value & 0xFFFF));
+        write_u16(out, static_cast<uint16_t>(value >> 16));
+    }
+
+    static void write_u64(SimpelVector<char>& out, uint64_t value) {
+        write_u32(out, static_cast<uint32_t>(value & 0xFFFFFFFF));
+        write_u32(out, static_cast<uint32_t>(value >> 32));
+    }
+
+    // bounds-checked little-endian reader over the input bytes
+    class Reader {
+    private:
+        const unsigned char* m_Data;
+        size_t m_Size;
+        size_t m_Position;
+    public:
+        Reader(const char* data, size_t size)
+            : m_Data(reinterpret_cast<const unsigned char*>(data)), m_Size(size), m_Position(0) {}
+
+        void need(size_t bytes) const {
+            if (bytes > m_Size - m_Position) {
+                throw std::runtime_error("Truncated roaring bitmap data");
+            }
+        }
+
+        void skip(size_t bytes) {
+            need(bytes);
+            m_Position += bytes;
+        }
+
+        uint8_t u8() {
+            need(1);
+            return m_Data[m_Position++];
+        }
+
+        uint16_t u16() {
+            const uint16_t low = u8();
+            return static_cast<uint16_t>(low | (uint16_t(u8()) << 8));
+        }
+
+        uint32_t u32() {
+            const uint32_t low = u16();
+            return low | (uint32_t(u16()) << 16);
+        }
+
+        uint64_t u64() {
+            const uint64_t low = u32();
+            return low | (uint64_t(u32()) << 32);
+        }
+
+        size_t position() const { return m_Position; }
+    };
+
+public:
+    RoaringBitmap() = default;
+
+    // build from a strictly increasing list of values (e.g. a posting list)
+    static RoaringBitmap from_sorted(const SimpelVector<uint32_t>& values) {
+        const uint32_t* data = values.data();
+        for (size_t i = 1; i < values.size(); ++i) {
+            if (data[i] <= data[i - 1]) {
+                throw std::invalid_argument("Values must be strictly increasing");
+            }
+        }
+
+        RoaringBitmap result;
+        size_t i = 0;
+        while (i < values.size()) {
+            const uint16_t key = static_cast<uint16_t>(data[i] >> 16);
+            size_t end = i;
+            while (end < values.size() && (data[end] >> 16) == key) {
+                ++end;
+            }
+
+            Container c;
+            c.cardinality = static_cast<uint32_t>(end - i);
+            if (c.cardinality > kArrayLimit) {
+                c = make_bitmap();
+                c.cardinality = static_cast<uint32_t>(end - i);
+                for (size_t k = i; k < end; ++k) {
+                    c.bits.data()[(data[k] & 0xFFFF) / 64] |= uint64_t(1) << (data[k] % 64);
+                }
+            } else {
+                c.values.reserve(c.cardinality);
+                for (size_t k = i; k < end; ++k) {
+                    c.values.push_back(static_cast<uint16_t>(data[k] & 0xFFFF));
+                }
+            }
+            result.append_container(key, std::move(c));
+            i = end;
+        }
+        return result;
+    }
+
+    // insert 'value'; run containers are expanded first (call run_optimize() again after bulk adds)
+    void add(uint32_t value) {
+        const uint16_t key = static_cast<uint16_t>(value >> 16);
+        const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+        const size_t index = find_key(key);
+        if (!has_key(index, key)) {
+            // new container, rotated into place to keep the keys sorted
+            Container c;
+            c.values.push_back(low);
+            c.cardinality = 1;
+            append_container(key, std::move(c));
+            std::rotate(m_Keys.begin() + index, m_Keys.end() - 1, m_Keys.end());
+            std::rotate(m_Containers.begin() + index, m_Containers.end() - 1, m_Containers.end());
+            return;
+        }
+
+        Container& c = m_Containers.data()[index];
+        if (c.kind == Kind::Run) {
+            if (container_contains(c, low)) {
+                return;
+            }
+            c = run_to_plain(c);
+        }
+        if (c.kind == Kind::Array) {
+            uint16_t* first = c.values.data();
+            uint16_t* it = std::lower_bound(first, first + c.values.size(), low);
+            if (it != first + c.values.size() && *it == low) {
+                return;
+            }
+            if (c.cardinality == kArrayLimit) {
+                c = array_to_bitmap(c);
+            } else {
+                const size_t position = static_cast<size_t>(it - first);
+                c.values.push_back(low);
+                std::rotate(c.values.begin() + position, c.values.end() - 1, c.values.end());
+                ++c.cardinality;
+                return;
+            }
+        }
+        uint64_t& word = c.bits.data()[low / 64];
+        const uint64_t bit = uint64_t(1) << (low % 64);
+        c.cardinality += (word & bit) ? 0 : 1;
+        word |= bit;
+    }
+
+    bool contains(uint32_t value) const {
+        const uint16_t key = static_cast<uint16_t>(value >> 16);
+        const size_t index = find_key(key);
+        return has_key(index, key) && container_contains(m_Containers.data()[index], static_cast<uint16_t>(value & 0xFFFF));
+    }
+
+    // Convert every container to the run form where that is smaller than the
+    // array or bitmap form (and back when it no longer is).
+    void run_optimize() {
+        for (auto& container : m_Containers) {
+            Container scratch;
+            Container c = plain(container, scratch);
+
+            // count the runs of the plain form
+            SimpelVector<uint16_t> runs;
+            auto add_value = [&](uint32_t v) {
+                const size_t n = runs.size();
+                if (n > 0 && uint32_t(runs.data()[n - 2]) + runs.data()[n - 1] + 1 == v) {
+                    ++runs.data()[n - 1];
+                } else {
+                    runs.push_back(static_cast<uint16_t>(v));
+                    runs.push_back(0);
+                }
+            };
+            if (c.kind == Kind::Array) {
+                for (const auto& value : c.values) {
+                    add_value(value);
+                }
+            } else {
+                for (size_t w = 0; w < kBitmapWords; ++w) {
+                    for (uint64_t word = c.bits.data()[w]; word; word &= word - 1) {
+                        add_value(static_cast<uint32_t>(w * 64 + std::countr_zero(word)));
+                    }
+                }
+            }
+
+            // serialized sizes: run 2 + 4 per run, array 2 per value, bitmap 8 KiB
+            const size_t run_bytes = 2 + 2 * runs.size();
+            const size_t plain_bytes = c.kind == Kind::Array ? 2 * size_t(c.cardinality) : kBitmapWords * 8;
+            if (run_bytes < plain_bytes) {
+                Container run;
+                run.kind = Kind::Run;
+                run.cardinality = c.cardinality;
+                run.values.swap(runs);
+                container = std::move(run);
+            } else {
+                container = std::move(c);
+            }
+        }
+    }
+
+    // call fn(value) for every value in increasing order
+    template <typename F>
+    void for_each(F fn) const {
+        for (size_t k = 0; k < m_Keys.size(); ++k) {
+            const uint32_t high = uint32_t(m_Keys.data()[k]) << 16;
+            const Container& c = m_Containers.data()[k];
+            if (c.kind == Kind::Array) {
+                for (const auto& value : c.values) {
+                    fn(high | value);
+                }
+            } else if (c.kind == Kind::Bitmap) {
+                for (size_t w = 0; w < kBitmapWords; ++w) {
+                    for (uint64_t word = c.bits.data()[w]; word; word &= word - 1) {
+                        fn(high | static_cast<uint32_t>(w * 64 + std::countr_zero(word)));
+                    }
+                }
+            } else {
+                const uint16_t* runs = c.values.data();
+                for (size_t r = 0; r < c.runs(); ++r) {
+                    for (uint32_t v = runs[2 * r]; v <= uint32_t(runs[2 * r]) + runs[2 * r + 1]; ++v) {
+                        fn(high | v);
+                    }
+                }
+            }
+        }
+    }
+
+    // all values as a sorted vector
+    SimpelVector<uint32_t> to_vector() const {
+        SimpelVector<uint32_t> result;
+        result.reserve(static_cast<size_t>(cardinality()));
+        for_each([&](uint32_t value) { result.push_back(value); });
+        return result;
+    }
+
+    // number of values (sum of the cached container cardinalities)
+    uint64_t cardinality() const {
+        uint64_t total = 0;
+        for (const auto& c : m_Containers) {
+            total += c.cardinality;
+        }
+        return total;
+    }
+
+    bool empty() const { return m_Keys.empty(); }
+    size_t containers() const { return m_Keys.size(); }
+
+    friend RoaringBitmap operator&(const RoaringBitmap& a, const RoaringBitmap& b) {
+        return merge(a, b, false, false, intersect);
+    }
+
+    friend RoaringBitmap operator|(const RoaringBitmap& a, const RoaringBitmap& b) {
+        return merge(a, b, true, true, unite);
+    }
+
+    // and-not: the values of 'a' that are not in 'b'
+    friend RoaringBitmap operator-(const RoaringBitmap& a, const RoaringBitmap& b) {
+        return merge(a, b, true, false, subtract);
+    }
+
+    void swap(RoaringBitmap& other) noexcept {
+        m_Keys.swap(other.m_Keys);
+        m_Containers.swap(other.m_Containers);
+    }
+
+    // Portable Roaring format:
+    //   header:  cookie 12346 + container count, or cookie 12347 | (count - 1) << 16
+    //            followed by one "is run container" bit per container
+    //   per container: key, cardinality - 1 (uint16 each)
+    //   offsets: uint32 byte offset of each container (omitted for small run bitmaps)
+    //   payload: array values, 1024 bitmap words, or run count + (start, length - 1) pairs
+    SimpelVector<char> serialize() const {
+        const size_t count = m_Keys.size();
+        bool has_runs = false;
+        for (const auto& c : m_Containers) {
+            has_runs = has_runs || c.kind == Kind::Run;
+        }
+
+        SimpelVector<char> out;
+        if (has_runs) {
+            write_u32(out, kCookie | (static_cast<uint32_t>(count - 1) << 16));
+            for (size_t byte = 0; byte < (count + 7) / 8; ++byte) {
+                unsigned char flags = 0;
+                for (size_t k = byte * 8; k < count && k < byte * 8 + 8; ++k) {
+                    flags |= static_cast<unsigned char>((m_Containers.data()[k].kind == Kind::Run) << (k % 8));
+                }
+                out.push_back(static_cast<char>(flags));
+            }
+        } else {
+            write_u32(out, kCookieNoRuns);
+            write_u32(out, static_cast<uint32_t>(count));
+        }
+        for (size_t k = 0; k < count; ++k) {
+            write_u16(out, m_Keys.data()[k]);
+            write_u16(out, static_cast<uint16_t>(m_Containers.data()[k].cardinality - 1));
+        }
+
+        if (!has_runs || count >= kNoOffsetThreshold) {
+            size_t offset = out.size() + 4 * count;
+            for (const auto& c : m_Containers) {
+                write_u32(out, static_cast<uint32_t>(offset));
+                offset += c.kind == Kind::Bitmap ? kBitmapWords * 8 : 2 * c.values.size() + (c.kind == Kind::Run ? 2 : 0);
+            }
+        }
+
+        for (const auto& c : m_Containers) {
+            if (c.kind == Kind::Bitmap) {
+                for (const auto& word : c.bits) {
+                    write_u64(out, word);
+                }
+            } else {
+                if (c.kind == Kind::Run) {
+                    write_u16(out, static_cast<uint16_t>(c.runs()));
+                }
+                for (const auto& value : c.values) {
+                    write_u16(out, value);
+                }
+            }
+        }
+        return out;
+    }
+
+    // Read the portable format; throws std::runtime_error on malformed input,
+    // including containers that break the invariants the other members rely on
+    // (unsorted or overlapping runs, cardinalities that do not match the header,
+    // bitmap containers of kArrayLimit values or fewer).
+    static RoaringBitmap deserialize(const char* data, size_t size) {
+        Reader in(data, size);
+        const uint32_t cookie = in.u32();
+        size_t count;
+        bool has_runs;
+        SimpelVector<unsigned char> run_flags;
+        if ((cookie & 0xFFFF) == kCookie) {
+            has_runs = true;
+            count = (cookie >> 16) + 1;
+            run_flags.resize((count + 7) / 8);
+            for (auto& flags : run_flags) {
+                flags = in.u8();
+            }
+        } else if (cookie == kCookieNoRuns) {
+            has_runs = false;
+            count = in.u32();
+            if (count > 65536) {
+                throw std::runtime_error("Invalid roaring bitmap container count");
+            }
+        } else {
+            throw std::runtime_error("Unknown roaring bitmap cookie");
+        }
+
+        SimpelVector<uint32_t> cardinalities;
+        RoaringBitmap result;
+        in.need(4 * count);
+        for (size_t k = 0; k < count; ++k) {
+            const uint16_t key = in.u16();
+            if (k > 0 && key <= result.m_Keys.data()[k - 1]) {
+                throw std::runtime_error("Roaring bitmap keys are not increasing");
+            }
+            result.m_Keys.push_back(key);
+            cardinalities.push_back(uint32_t(in.u16()) + 1);
+        }
+        if (!has_runs || count >= kNoOffsetThreshold) {
+            in.skip(4 * count); // containers are read in order, the offsets are not needed
+        }
+
+        result.m_Containers.reserve(count);
+        for (size_t k = 0; k < count; ++k) {
+            Container c;
+            if (has_runs && ((run_flags.data()[k / 8] >> (k % 8)) & 1)) {
+                c.kind = Kind::Run;
+                const size_t runs = in.u16();
+                if (runs == 0) {
+                    throw std::runtime_error("Empty roaring run container");
+                }
+                in.need(4 * runs);
+                for (size_t r = 0; r < runs; ++r) {
+                    const uint16_t start = in.u16();
+                    const uint16_t length = in.u16();
+                    if (uint32_t(start) + length > 0xFFFF) {
+                        throw std::runtime_error("Roaring run exceeds its container");
+                    }
+                    if (r > 0 && start <= uint32_t(c.values.data()[2 * r - 2]) + c.values.data()[2 * r - 1]) {
+                        throw std::runtime_error("Roaring runs are not sorted and disjoint");
+                    }
+                    c.values.push_back(start);
+                    c.values.push_back(length);
+                    c.cardinality += uint32_t(length) + 1;
+                }
+                if (c.cardinality != cardinalities.data()[k]) {
+                    throw std::runtime_error("Roaring run container cardinality does not match its header");
+                }
+            } else if (cardinalities.data()[k] > kArrayLimit) {
+                c = make_bitmap();
+                in.need(kBitmapWords * 8);
+                for (auto& word : c.bits) {
+                    word = in.u64();
+                    c.cardinality += static_cast<uint32_t>(std::popcount(word));
+                }
+                // the header said > kArrayLimit, so this also rules out small (or empty) bitmaps
+                if (c.cardinality != cardinalities.data()[k]) {
+                    throw std::runtime_error("Roaring bitmap container cardinality does not match its header");
+                }
+            } else {
+                c.cardinality = cardinalities.data()[k];
+                in.need(2 * size_t(c.cardinality));
+                c.values.reserve(c.cardinality);
+                for (uint32_t v = 0; v < c.cardinality; ++v) {
+                    const uint16_t value = in.u16();
+                    if (v > 0 && value <= c.values.data()[v - 1]) {
+                        throw std::runtime_error("Roaring array container is not sorted");
+                    }
+                    c.values.push_back(value);
+                }
+            }
+            result.m_Containers.push_back(std::move(c));
+        }
+        return result;
+    }
+};
@@ -0,0 +1,371 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include <stdexcept>
+#include <iterator>
+#include <type_traits>
+
+#include "StreamingCopy.h"
+
+// Where a SimpelVector gets its buffer from. The default is new T[] / delete[];
+// a storage policy with the same three static functions can replace it (see
+// SlabStorage in SlabAllocator.h). try_expand() grows a buffer in place and
+// returns false if it cannot, in which case the vector reallocates and moves.
+struct NewArrayStorage {
+    template <typename T>
+    static constexpr T* allocate(size_t count) { return new T[count]; }
+
+    template <typename T>
+    static constexpr void deallocate(T* data, size_t) { delete[] data; }
+
+    template <typename T>
+    static constexpr bool try_expand(T*, size_t, size_t) { return false; }
+};
+
+// Simple dynamic array class template (similar to a tiny std::vector)
+// Everything is constexpr, so a SimpelVector can also be built and used during
+// constant evaluation (C++20 constexpr new/delete); see ConstexprTable.h.
+template <typename T, typename Storage = NewArrayStorage>
+class SimpelVector {
+private:
+    T* m_Data;         // pointer to the allocated array
+    size_t m_Size;     // number of elements currently stored
+    size_t m_Capacity; // allocated capacity (number of T objects that fit without realloc)
+
+    // Resize the internal buffer to at least new_capacity.
+    // If new_capacity < m_Size, we bump it up to m_Size so we don't lose elements.
+    // Growing first asks the storage to expand the buffer in place; otherwise this
+    // allocates a new dynamic array, moves existing elements into it,
+    // deletes the old array and updates the pointer and capacity.
+    constexpr void resize_capacity(size_t new_capacity) {
+        if (new_capacity < m_Size) {
+            new_capacity = m_Size;
+        }
+        if (m_Data && new_capacity > m_Capacity && Storage::try_expand(m_Data, m_Capacity, new_capacity)) {
+            m_Capacity = new_capacity;
+            return;
+        }
+
+        T* new_data = Storage::template allocate<T>(new_capacity);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            copy_elements(new_data, m_Data, m_Size); // a move is a copy: may stream
+        } else {
+            for (size_t i = 0; i < m_Size; ++i) {
+                // Move elements into the new storage (note: requires T to be move-assignable)
+                new_data[i] = std::move(m_Data[i]);
+            }
+        }
+        Storage::deallocate(m_Data, m_Capacity); // free old storage
+        m_Data = new_data;
+        m_Capacity = new_capacity;
+    }
+
+    // dst[i] = src[i] for count elements; huge blocks of trivially copyable
+    // elements use streaming stores (see StreamingCopy.h) to spare the cache
+    static constexpr void copy_elements(T* dst, const T* src, size_t count) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (!std::is_constant_evaluated() && count >= streaming_threshold() / sizeof(T) && count > 0) {
+                stream_copy(dst, src, count * sizeof(T));
+                return;
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] = src[i];
+        }
+    }
+
+    // dst[i] = value for count elements, streaming like copy_elements
+    static constexpr void fill_elements(T* dst, size_t count, const T& value) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (!std::is_constant_evaluated() && count >= streaming_threshold() / sizeof(T) && count > 0) {
+                stream_fill(dst, count, value);
+                return;
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] = value;
+        }
+    }
+
+    // trace copies and moves at runtime (std::cout is not usable during constant evaluation)
+    static constexpr void log(const char* message) {
+        if (!std::is_constant_evaluated()) {
+            std::cout << message << std::endl;
+        }
+    }
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+
+    // Random-access iterator (non-const)
+    // The typedefs let std algorithms (std::sort, std::lower_bound, ...) work on SimpelVector.
+    class Iterator {
+    private:
+        T* m_Ptr;
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::contiguous_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        constexpr Iterator() : m_Ptr(nullptr) {}
+        constexpr Iterator(T* ptr) : m_Ptr(ptr) {}
+        constexpr T& operator*() const { return *m_Ptr; }             // dereference
+        constexpr T* operator->() const { return m_Ptr; }
+        constexpr T& operator[](difference_type n) const { return m_Ptr[n]; }
+        constexpr Iterator& operator++() { ++m_Ptr; return *this; }   // pre-increment
+        constexpr Iterator operator++(int) { Iterator tmp = *this; ++m_Ptr; return tmp; } // post-increment
+        constexpr Iterator& operator--() { --m_Ptr; return *this; }   // pre-decrement
+        constexpr Iterator operator--(int) { Iterator tmp = *this; --m_Ptr; return tmp; } // post-decrement
+        constexpr Iterator& operator+=(difference_type n) { m_Ptr += n; return *this; }
+        constexpr Iterator& operator-=(difference_type n) { m_Ptr -= n; return *this; }
+        constexpr Iterator operator+(difference_type n) const { return Iterator(m_Ptr + n); }
+        constexpr Iterator operator-(difference_type n) const { return Iterator(m_Ptr - n); }
+        friend constexpr Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+        constexpr difference_type operator-(const Iterator& other) const { return m_Ptr - other.m_Ptr; }
+        constexpr bool operator==(const Iterator& other) const { return m_Ptr == other.m_Ptr; }
+        constexpr bool operator!=(const Iterator& other) const { return m_Ptr != other.m_Ptr; }
+        constexpr bool operator<(const Iterator& other) const { return m_Ptr < other.m_Ptr; }
+        constexpr bool operator>(const Iterator& other) const { return m_Ptr > other.m_Ptr; }
+        constexpr bool operator<=(const Iterator& other) const { return m_Ptr <= other.m_Ptr; }
+        constexpr bool operator>=(const Iterator& other) const { return m_Ptr >= other.m_Ptr; }
+    };
+
+    // Const iterator
+    class ConstIterator {
+    private:
+        const T* m_Ptr;
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::contiguous_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        constexpr ConstIterator() : m_Ptr(nullptr) {}
+        constexpr ConstIterator(const T* ptr) : m_Ptr(ptr) {}
+        constexpr const T& operator*() const { return *m_Ptr; }
+        constexpr const T* operator->() const { return m_Ptr; }
+        constexpr const T& operator[](difference_type n) const { return m_Ptr[n]; }
+        constexpr ConstIterator& operator++() { ++m_Ptr; return *this; }
+        constexpr ConstIterator operator++(int) { ConstIterator tmp = *this; ++m_Ptr; return tmp; }
+        constexpr ConstIterator& operator--() { --m_Ptr; return *this; }
+        constexpr ConstIterator operator--(int) { ConstIterator tmp = *this; --m_Ptr; return tmp; }
+        constexpr ConstIterator& operator+=(difference_type n) { m_Ptr += n; return *this; }
+        constexpr ConstIterator& operator-=(difference_type n) { m_Ptr -= n; return *this; }
+        constexpr ConstIterator operator+(difference_type n) const { return ConstIterator(m_Ptr + n); }
+        constexpr ConstIterator operator-(difference_type n) const { return ConstIterator(m_Ptr - n); }
+        friend constexpr ConstIterator operator+(difference_type n, const ConstIterator& it) { return it + n; }
+        constexpr difference_type operator-(const ConstIterator& other) const { return m_Ptr - other.m_Ptr; }
+        constexpr bool operator==(const ConstIterator& other) const { return m_Ptr == other.m_Ptr; }
+        constexpr bool operator!=(const ConstIterator& other) const { return m_Ptr != other.m_Ptr; }
+        constexpr bool operator<(const ConstIterator& other) const { return m_Ptr < other.m_Ptr; }
+        constexpr bool operator>(const ConstIterator& other) const { return m_Ptr > other.m_Ptr; }
+        constexpr bool operator<=(const ConstIterator& other) const { return m_Ptr <= other.m_Ptr; }
+        constexpr bool operator>=(const ConstIterator& other) const { return m_Ptr >= other.m_Ptr; }
+    };
+
+    // Default constructor: start empty
+    constexpr SimpelVector() : m_Data(nullptr), m_Size(0), m_Capacity(0) {}
+
+    // Initializer-list constructor: push each element
+    constexpr SimpelVector(std::initializer_list<T> init) : SimpelVector() {
+        for (const auto& val : init) {
+            push_back(val);
+        }
+    }
+
+    // Copy constructor: deep copy of the other SimpelVector
+    constexpr SimpelVector(const SimpelVector& other) : m_Data(nullptr), m_Size(other.m_Size), m_Capacity(other.m_Capacity) {
+        log("Copy constructor called");
+        if (other.m_Data) {
+            m_Data = Storage::template allocate<T>(m_Capacity);
+            copy_elements(m_Data, other.m_Data, m_Size);
+        }
+    }
+
+    // Move constructor: take ownership of other's buffer and leave it empty
+    constexpr SimpelVector(SimpelVector&& other) noexcept : m_Data(other.m_Data), m_Size(other.m_Size), m_Capacity(other.m_Capacity) {
+        log("Move constructor called");
+        other.m_Data = nullptr;
+        other.m_Size = 0;
+        other.m_Capacity = 0;
+    }
+
+    // Copy assignment operator
+    constexpr SimpelVector& operator=(const SimpelVector& other) {
+        log("Copy assignment operator called");
+        if (this != &other) {
+            // allocate new buffer (or nullptr if other has no data)
+            T* new_data = other.m_Data ? Storage::template allocate<T>(other.m_Capacity) : nullptr;
+
+            if (new_data) {
+                copy_elements(new_data, other.m_Data, other.m_Size);
+            }
+
+            Storage::deallocate(m_Data, m_Capacity); // free existing storage
+
+            // replace members with the new buffer
+            m_Data = new_data;
+            m_Size = other.m_Size;
+            m_Capacity = other.m_Capacity;
+        }
+        return *this;
+    }
+
+    // Move assignment operator: free current buffer, steal other's buffer
+    constexpr SimpelVector& operator=(SimpelVector&& other) noexcept {
+        log("Move assignment operator called");
+        if (this != &other) {
+            Storage::deallocate(m_Data, m_Capacity); // free current storage
+            m_Data = other.m_Data;          // steal pointer
+            m_Size = other.m_Size;
+            m_Capacity = other.m_Capacity;
+            other.m_Data = nullptr;         // leave other in valid empty state
+            other.m_Size = 0;
+            other.m_Capacity = 0;
+        }
+        return *this;
+    }
+
+    // Destructor: free allocated storage
+    constexpr ~SimpelVector() { Storage::deallocate(m_Data, m_Capacity); }
+
+    // Index operator (non-const): checks bounds and returns reference
+    constexpr T& operator[](size_t index) {
+        if (index >= m_Size) {
+            throw std::out_of_range("Index out of range");
+        }
+        return m_Data[index];
+    }
+
+    // Index operator (const)
+    constexpr const T& operator[](size_t index) const {
+        if (index >= m_Size) {
+            throw std::out_of_range("Index out of range");
+        }
+        return m_Data[index];
+    }
+
+    // push_back for lvalue references (copy)
+    constexpr void push_back(const T& value) {
+        if (m_Size == m_Capacity) {
+            // grow: if capacity is 0 set to 1, otherwise double
+            resize_capacity(m_Capacity == 0 ? 1 : m_Capacity * 2);
+        }
+        m_Data[m_Size] = value; // copy-assign into next slot
+        ++m_Size;               // only once the assignment did not throw
+    }
+
+    // push_back for rvalue references (move)
+    constexpr void push_back(T&& value) {
+        if (m_Size == m_Capacity) {
+            resize_capacity(m_Capacity == 0 ? 1 : m_Capacity * 2);
+        }
+        m_Data[m_Size] = std::move(value); // move-assign
+        ++m_Size;
+    }
+
+    // append: copy 'count' elements to the end, growing the buffer at most once
+    // (to the next doubling step that fits) instead of once per element
+    // values must not point into this vector, since growing frees the old buffer
+    constexpr void append(const T* values, size_t count) {
+        if (m_Size + count > m_Capacity) {
+            size_t new_capacity = m_Capacity == 0 ? 1 : m_Capacity;
+            while (new_capacity < m_Size + count) {
+                new_capacity *= 2;
+            }
+            resize_capacity(new_capacity);
+        }
+        copy_elements(m_Data + m_Size, values, count);
+        m_Size += count;
+    }
+
+    // pop_back: remove last element (doesn't call destructor explicitly)
+    constexpr void pop_back() {
+        if (m_Size == 0) {
+            throw std::out_of_range("Vector is empty");
+        }
+        --m_Size; // just reduce size; element's destructor is not called here
+    }
+
+    // reserve: ensure capacity is at least new_capacity
+    constexpr void reserve(size_t new_capacity) {
+        if (new_capacity <= m_Capacity) {
+            return;
+        }
+        resize_capacity(new_capacity);
+    }
+
+    // resize: grow to new_size elements (new ones are copies of 'value') or shrink
+    // growing past the capacity reallocates to exactly new_size, like reserve
+    constexpr void resize(size_t new_size, const T& value = T()) {
+        reserve(new_size);
+        if (new_size > m_Size) {
+            fill_elements(m_Data + m_Size, new_size - m_Size, value);
+        }
+        m_Size = new_size;
+    }
+
+    // reverse: create a new buffer with elements in reverse order
+    // keeps the current capacity (allocates m_Capacity size)
+    constexpr void reverse() {
+        if (m_Size <= 1) {
+            return;
+        }
+
+        T* reversed_data = Storage::template allocate<T>(m_Capacity);
+        for (size_t i = 0; i < m_Size; ++i) {
+            // move elements from the end into the new buffer in forward order
+            reversed_data[i] = std::move(m_Data[m_Size - 1 - i]);
+        }
+
+        Storage::deallocate(m_Data, m_Capacity);
+        m_Data = reversed_data;
+    }
+
+    // shrink_to_fit: reduce capacity to match size (reallocates)
+    constexpr void shrink_to_fit() {
+        if (m_Size < m_Capacity) {
+            resize_capacity(m_Size);
+        }
+    }
+
+    // clear: logically remove all elements by setting size to 0
+    // NOTE: this does not explicitly call element destructors
+    constexpr void clear() { m_Size = 0; }
+
+    // swap: exchange buffers with another SimpelVector
+    // no elements are copied or moved, so this never allocates
+    constexpr void swap(SimpelVector& other) noexcept {
+        std::swap(m_Data, other.m_Data);
+        std::swap(m_Size, other.m_Size);
+        std::swap(m_Capacity, other.m_Capacity);
+    }
+
+    // accessors
+    constexpr size_t size() const { return m_Size; }
+    constexpr size_t capacity() const { return m_Capacity; }
+    constexpr bool empty() const { return m_Size == 0; }
+
+    // raw access to the underlying buffer (nullptr while nothing was allocated)
+    constexpr T* data() { return m_Data; }
+    constexpr const T* data() const { return m_Data; }
+
+    // iterator access
+    constexpr Iterator begin() { return Iterator(m_Data); }
+    constexpr Iterator end() { return Iterator(m_Data + m_Size); }
+
+    constexpr ConstIterator begin() const { return ConstIterator(m_Data); }
+    constexpr ConstIterator end() const { return ConstIterator(m_Data + m_Size); }
+
+    constexpr ConstIterator cbegin() const { return ConstIterator(m_Data); }
+    constexpr ConstIterator cend() const { return ConstIterator(m_Data + m_Size); }
+};
@@ -0,0 +1,387 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include "SimpelVector.h"
+
+// Size-class allocator for vector buffers.
+// push_back doubles the capacity, so buffers come in power-of-two sizes. Every
+// request is rounded up to a power of two between 64 bytes and 2 MiB and served
+// from 4 MiB chunks managed as buddy blocks: a block of size 2^k sits at an
+// offset aligned to 2^k, and its "next slab" (the buddy right behind it) can be
+// merged with it. That makes try_expand() possible: a buffer that is the left
+// half of a free pair doubles in place, with no copy.
+//
+// Blocks up to 64 KiB are cached in per-thread free lists, so the common
+// allocate/deallocate churn of one thread does not touch the shared lock.
+// Requests above 2 MiB bypass the chunks and are mapped directly from the OS
+// (mmap / VirtualAlloc).
+//
+// The API is sized like operator delete(void*, size_t): deallocate() and
+// try_expand() must be given the size of the latest successful allocate/try_expand.
+//
+// SlabVector<T> (SimpelVector with SlabStorage, below) takes its buffers from
+// here, so push_back growth doubles in place whenever the buddy is free.
+class SlabAllocator {
+public:
+    static constexpr size_t kMinShift = 6;   // smallest block: 64 bytes
+    static constexpr size_t kMaxShift = 21;  // largest block: 2 MiB
+    static constexpr size_t kChunkShift = 22;
+    static constexpr size_t kChunkSize = size_t(1) << kChunkShift;
+    static constexpr size_t kCacheMaxShift = 16; // blocks up to 64 KiB go through thread caches
+    static constexpr size_t kCacheLimit = 32;    // blocks per class in one thread cache
+    static constexpr size_t kPageSize = 4096;
+
+    // Process-wide allocator. Like malloc it has to outlive every thread cache,
+    // and threads may exit after static destruction has begun, so it is never
+    // destroyed: its chunks go back to the OS with the process.
+    static SlabAllocator& instance() {
+        static SlabAllocator* allocator = new SlabAllocator();
+        return *allocator;
+    }
+
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+    // number of bytes actually available for a request of 'size' bytes
+    static size_t usable_size(size_t size) {
+        const size_t order = order_of(size);
+        if (order > kMaxShift) {
+            return (size + kPageSize - 1) & ~(kPageSize - 1);
+        }
+        return size_t(1) << order;
+    }
+
+    void* allocate(size_t size) {
+        const size_t order = order_of(size);
+        if (order > kMaxShift) {
+            return os_map(usable_size(size));
+        }
+
+        if (order <= kCacheMaxShift) {
+            ThreadCache& cache = thread_cache();
+            const size_t c = order - kMinShift;
+            if (cache.heads[c]) {
+                void* block = cache.heads[c];
+                cache.heads[c] = *static_cast<void**>(block);
+                --cache.counts[c];
+                return block;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return buddy_allocate(order);
+    }
+
+    void deallocate(void* p, size_t size) {
+        if (!p) {
+            return;
+        }
+        const size_t order = order_of(size);
+        if (order > kMaxShift) {
+            os_unmap(p, usable_size(size));
+            return;
+        }
+
+        if (order <= kCacheMaxShift) {
+            ThreadCache& cache = thread_cache();
+            const size_t c = order - kMinShift;
+            if (cache.counts[c] < kCacheLimit) {
+                *static_cast<void**>(p) = cache.heads[c];
+                cache.heads[c] = p;
+                ++cache.counts[c];
+                return;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        buddy_free(p, order);
+    }
+
+    // Grow the block at 'p' from old_size to new_size without moving it.
+    // Succeeds when new_size still fits the block's size class, or when the
+    // following buddies up to the new class are free. On failure nothing changes
+    // and the caller has to allocate/copy/deallocate as usual.
+    bool try_expand(void* p, size_t old_size, size_t new_size) {
+        if (new_size <= usable_size(old_size)) {
+            return true;
+        }
+        const size_t order = order_of(old_size);
+        const size_t new_order = order_of(new_size);
+        if (order > kMaxShift || new_order > kMaxShift) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        unsigned char* chunk = chunk_of(p);
+        const size_t offset = static_cast<size_t>(static_cast<unsigned char*>(p) - chunk);
+
+        // every level up to new_order needs us to be the left half and the right half free
+        for (size_t k = order; k < new_order; ++k) {
+            if (offset & (size_t(1) << k)) {
+                return false;
+            }
+            if (header(chunk)->order[(offset + (size_t(1) << k)) >> kMinShift] != (k | kFreeBit)) {
+                return false;
+            }
+        }
+        for (size_t k = order; k < new_order; ++k) {
+            unsigned char* buddy = chunk + offset + (size_t(1) << k);
+            unlink(reinterpret_cast<FreeBlock*>(buddy), k);
+        }
+        header(chunk)->order[offset >> kMinShift] = static_cast<unsigned char>(new_order);
+        return true;
+    }
+
+    // number of 4 MiB chunks taken from the OS so far
+    size_t chunk_count() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Chunks.size();
+    }
+
+private:
+    static constexpr unsigned char kFreeBit = 0x80;
+    static constexpr size_t kHeaderShift = 16; // chunk header occupies the first 64 KiB block
+    static constexpr size_t kCacheClasses = kCacheMaxShift - kMinShift + 1;
+
+    // per-chunk metadata: for every 64-byte unit that starts a block, its order
+    // (with kFreeBit set while the block sits in a free list)
+    struct ChunkHeader {
+        unsigned char order[kChunkSize >> kMinShift];
+    };
+    static_assert(sizeof(ChunkHeader) <= (size_t(1) << kHeaderShift), "chunk header must fit its block");
+
+    // free blocks are linked through their own first bytes
+    struct FreeBlock {
+        FreeBlock* prev;
+        FreeBlock* next;
+    };
+
+    struct ThreadCache {
+        void* heads[kCacheClasses] = {};
+        size_t counts[kCacheClasses] = {};
+
+        // give cached blocks back when the thread exits
+        ~ThreadCache() {
+            SlabAllocator& allocator = SlabAllocator::instance();
+            std::lock_guard<std::mutex> lock(allocator.m_Mutex);
+            for (size_t c = 0; c < kCacheClasses; ++c) {
+                while (heads[c]) {
+                    void* block = heads[c];
+                    heads[c] = *static_cast<void**>(block);
+                    allocator.buddy_free(block, c + kMinShift);
+                }
+            }
+        }
+    };
+
+    std::mutex m_Mutex;
+    FreeBlock* m_Free[kMaxShift + 1] = {};
+    std::vector<void*> m_Chunks;
+
+    SlabAllocator() = default;
+
+    static ThreadCache& thread_cache() {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+
+    static size_t order_of(size_t size) {
+        const size_t order = size <= 1 ? 0 : static_cast<size_t>(std::bit_width(size - 1));
+        return order < kMinShift ? kMinShift : order;
+    }
+
+    static unsigned char* chunk_of(void* p) {
+        return reinterpret_cast<unsigned char*>(reinterpret_cast<uintptr_t>(p) & ~(uintptr_t(kChunkSize) - 1));
+    }
+
+    static ChunkHeader* header(unsigned char* chunk) { return reinterpret_cast<ChunkHeader*>(chunk); }
+
+    void link(FreeBlock* block, size_t order) {
+        block->prev = nullptr;
+        block->next = m_Free[order];
+        if (m_Free[order]) {
+            m_Free[order]->prev = block;
+        }
+        m_Free[order] = block;
+
+        unsigned char* chunk = chunk_of(block);
+        header(chunk)->order[(reinterpret_cast<unsigned char*>(block) - chunk) >> kMinShift] =
+            static_cast<unsigned char>(order | kFreeBit);
+    }
+
+    void unlink(FreeBlock* block, size_t order) {
+        if (block->prev) {
+            block->prev->next = block->next;
+        } else {
+            m_Free[order] = block->next;
+        }
+        if (block->next) {
+            block->next->prev = block->prev;
+        }
+    }
+
+    // map a new chunk and hand everything but the header block to the free lists
+    void add_chunk() {
+        unsigned char* chunk = static_cast<unsigned char*>(os_map_aligned(kChunkSize));
+        m_Chunks.push_back(chunk);
+        header(chunk)->order[0] = static_cast<unsigned char>(kHeaderShift); // header: allocated forever
+        for (size_t k = kHeaderShift; k <= kMaxShift; ++k) {
+            link(reinterpret_cast<FreeBlock*>(chunk + (size_t(1) << k)), k);
+        }
+    }
+
+    // lock held
+    void* buddy_allocate(size_t order) {
+        size_t k = order;
+        while (k <= kMaxShift && !m_Free[k]) {
+            ++k;
+        }
+        if (k > kMaxShift) {
+            add_chunk();
+            k = kMaxShift;
+        }
+
+        FreeBlock* block = m_Free[k];
+        unlink(block, k);
+        unsigned char* bytes = reinterpret_cast<unsigned char*>(block);
+        // split down: the right halves go back to the free lists
+        while (k > order) {
+            --k;
+            link(reinterpret_cast<FreeBlock*>(bytes + (size_t(1) << k)), k);
+        }
+        unsigned char* chunk = chunk_of(block);
+        header(chunk)->order[(bytes - chunk) >> kMinShift] = static_cast<unsigned char>(order);
+        return block;
+    }
+
+    // lock held
+    void buddy_free(void* p, size_t order) {
+        unsigned char* chunk = chunk_of(p);
+        size_t offset = static_cast<size_t>(static_cast<unsigned char*>(p) - chunk);
+        // merge with the buddy as long as it is free and of the same order
+        while (order < kMaxShift) {
+            const size_t buddy = offset ^ (size_t(1) << order);
+            if (header(chunk)->order[buddy >> kMinShift] != (order | kFreeBit)) {
+                break;
+            }
+            unlink(reinterpret_cast<FreeBlock*>(chunk + buddy), order);
+            offset &= ~(size_t(1) << order);
+            ++order;
+        }
+        link(reinterpret_cast<FreeBlock*>(chunk + offset), order);
+    }
+
+    static void* os_map(size_t bytes) {
+#if defined(_WIN32)
+        void* p = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (!p) {
+            throw std::bad_alloc();
+        }
+#else
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+#endif
+        return p;
+    }
+
+    static void os_unmap(void* p, size_t bytes) {
+#if defined(_WIN32)
+        (void)bytes;
+        VirtualFree(p, 0, MEM_RELEASE);
+#else
+        munmap(p, bytes);
+#endif
+    }
+
+    // map 'bytes' at an address aligned to 'bytes' (needed to find a block's chunk)
+    static void* os_map_aligned(size_t bytes) {
+#if defined(_WIN32)
+        for (;;) {
+            // reserve twice the size to find an aligned address, then map exactly there;
+            // another thread may grab the range in between, in which case we retry
+            void* probe = VirtualAlloc(nullptr, bytes * 2, MEM_RESERVE, PAGE_NOACCESS);
+            if (!probe) {
+                throw std::bad_alloc();
+            }
+            uintptr_t aligned = (reinterpret_cast<uintptr_t>(probe) + bytes - 1) & ~(uintptr_t(bytes) - 1);
+            VirtualFree(probe, 0, MEM_RELEASE);
+            void* p = VirtualAlloc(reinterpret_cast<void*>(aligned), bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+            if (p) {
+                return p;
+            }
+        }
+#else
+        unsigned char* raw = static_cast<unsigned char*>(os_map(bytes * 2));
+        uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = (base + bytes - 1) & ~(uintptr_t(bytes) - 1);
+        // give back the unaligned head and the unused tail
+        if (aligned > base) {
+            munmap(raw, aligned - base);
+        }
+        size_t tail = (base + bytes * 2) - (aligned + bytes);
+        if (tail > 0) {
+            munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+        }
+        return reinterpret_cast<void*>(aligned);
+#endif
+    }
+};
+
+// SimpelVector storage policy on the slab allocator: growth first tries
+// try_expand(), so doubling a buffer whose buddy is free needs no copy.
+// Buffers are raw memory, so T must be trivially default constructible and
+// destructible (what new T[] would construct, it does not have to).
+struct SlabStorage {
+    template <typename T>
+    static T* allocate(size_t count) {
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                      "SlabStorage needs trivially constructible and destructible elements");
+        static_assert(alignof(T) <= (size_t(1) << SlabAllocator::kMinShift), "SlabStorage aligns to 64 bytes");
+        return static_cast<T*>(SlabAllocator::instance().allocate(count * sizeof(T)));
+    }
+
+    template <typename T>
+    static void deallocate(T* data, size_t count) { SlabAllocator::instance().deallocate(data, count * sizeof(T)); }
+
+    template <typename T>
+    static bool try_expand(T* data, size_t count, size_t new_count) {
+        return SlabAllocator::instance().try_expand(data, count * sizeof(T), new_count * sizeof(T));
+    }
+};
+
+template <typename T>
+using SlabVector = SimpelVector<T, SlabStorage>;
+
+// std-style allocator adaptor, e.g. std::vector<int, SlabStdAllocator<int>>
+template <typename T>
+struct SlabStdAllocator {
+    using value_type = T;
+
+    SlabStdAllocator() noexcept = default;
+    template <typename U>
+    SlabStdAllocator(const SlabStdAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) { return static_cast<T*>(SlabAllocator::instance().allocate(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) { SlabAllocator::instance().deallocate(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const SlabStdAllocator<U>&) const noexcept { return true; }
+};
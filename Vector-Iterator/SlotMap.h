@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "SimpelVector.h"
+
+// Handle to an element of a SlotMap: slot index plus the generation the slot
+// had when the element was inserted. Handles are plain values, 8 bytes.
+struct SlotHandle {
+    uint32_t index = 0xFFFFFFFF;
+    uint32_t generation = 0;
+
+    bool operator==(const SlotHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+// Slot map: elements live densely in a SimpelVector (contiguous iteration,
+// swap-and-pop erase) and are referred to by SlotHandles that go through an
+// indirection table of slots. Growth and erase move elements, but only the
+// slot's dense index changes, so handles stay valid.
+//
+// Every slot has a generation counter: odd while the slot holds an element,
+// even while it is free. Erasing bumps it, so a handle to an erased element
+// no longer matches and is detected as stale instead of reaching whatever
+// element reuses the slot. A slot whose counter would wrap around is retired.
+template <typename T>
+class SlotMap {
+private:
+    static constexpr uint32_t kNone = 0xFFFFFFFF;
+
+    struct Slot {
+        uint32_t target = kNone; // dense index while occupied, next free slot while free
+        uint32_t generation = 0; // odd = occupied
+    };
+
+    SimpelVector<T> m_Values;        // dense elements
+    SimpelVector<uint32_t> m_Owners; // slot of each dense element (patched by erase)
+    SimpelVector<Slot> m_Slots;
+    uint32_t m_FreeHead;             // first free slot, kNone if there is none
+
+    // slot index of 'handle' if it refers to a live element, kNone otherwise
+    uint32_t live_slot(SlotHandle handle) const {
+        if (handle.index >= m_Slots.size() || m_Slots.data()[handle.index].generation != handle.generation
+            || (handle.generation & 1) == 0) {
+            return kNone;
+        }
+        return handle.index;
+    }
+
+    // room for one more push_back without reallocating (same doubling as push_back)
+    template <typename U>
+    static void reserve_one(SimpelVector<U>& vec) {
+        if (vec.size() == vec.capacity()) {
+            vec.reserve(vec.capacity() == 0 ? 1 : vec.capacity() * 2);
+        }
+    }
+
+    // Push 'value' and give it a slot. Everything that can throw (the size
+    // checks, growing the side tables, copying the value) happens before a
+    // slot is published, so a failed insert leaves the map unchanged.
+    template <typename V>
+    SlotHandle insert_value(V&& value) {
+        if (m_Values.size() >= kNone || (m_FreeHead == kNone && m_Slots.size() >= kNone)) {
+            throw std::length_error("SlotMap is full");
+        }
+        if (m_FreeHead == kNone) {
+            reserve_one(m_Slots);
+        }
+        reserve_one(m_Owners);
+        m_Values.push_back(std::forward<V>(value));
+
+        // publish: no allocation left, cannot throw
+        uint32_t index = m_FreeHead;
+        if (index != kNone) {
+            m_FreeHead = m_Slots.data()[index].target;
+        } else {
+            index = static_cast<uint32_t>(m_Slots.size());
+            m_Slots.push_back(Slot());
+        }
+        Slot& slot = m_Slots.data()[index];
+        slot.target = static_cast<uint32_t>(m_Values.size() - 1);
+        ++slot.generation;
+        m_Owners.push_back(index);
+        return SlotHandle{ index, slot.generation };
+    }
+
+    // bump the generation of slot 'index' and put it on the free list
+    void release_slot(uint32_t index) {
+        Slot& slot = m_Slots.data()[index];
+        if (++slot.generation == 0) {
+            slot.target = kNone; // generation wrapped: retire the slot for good
+            slot.generation = kNone - 1;
+            return;
+        }
+        slot.target = m_FreeHead;
+        m_FreeHead = index;
+    }
+
+public:
+    SlotMap() : m_FreeHead(kNone) {}
+
+    SlotHandle insert(const T& value) { return insert_value(value); }
+
+    SlotHandle insert(T&& value) { return insert_value(std::move(value)); }
+
+    // Remove the element behind 'handle'; returns false for a stale handle.
+    // The last dense element moves into the hole and its slot is patched.
+    bool erase(SlotHandle handle) {
+        const uint32_t index = live_slot(handle);
+        if (index == kNone) {
+            return false;
+        }
+        const uint32_t position = m_Slots.data()[index].target;
+        const uint32_t last = static_cast<uint32_t>(m_Values.size() - 1);
+        if (position != last) {
+            m_Values.data()[position] = std::move(m_Values.data()[last]);
+            m_Owners.data()[position] = m_Owners.data()[last];
+            m_Slots.data()[m_Owners.data()[position]].target = position;
+        }
+        m_Values.pop_back();
+        m_Owners.pop_back();
+        release_slot(index);
+        return true;
+    }
+
+    // pointer to the element, or nullptr for a stale handle (valid until the next insert/erase)
+    T* get(SlotHandle handle) {
+        const uint32_t index = live_slot(handle);
+        return index == kNone ? nullptr : m_Values.data() + m_Slots.data()[index].target;
+    }
+
+    const T* get(SlotHandle handle) const {
+        const uint32_t index = live_slot(handle);
+        return index == kNone ? nullptr : m_Values.data() + m_Slots.data()[index].target;
+    }
+
+    T& at(SlotHandle handle) {
+        T* value = get(handle);
+        if (!value) {
+            throw std::out_of_range("Stale slot map handle");
+        }
+        return *value;
+    }
+
+    const T& at(SlotHandle handle) const {
+        const T* value = get(handle);
+        if (!value) {
+            throw std::out_of_range("Stale slot map handle");
+        }
+        return *value;
+    }
+
+    bool contains(SlotHandle handle) const { return live_slot(handle) != kNone; }
+
+    // handle of the element at dense position 'position' (e.g. while iterating)
+    SlotHandle handle_at(size_t position) const {
+        if (position >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        const uint32_t index = m_Owners.data()[position];
+        return SlotHandle{ index, m_Slots.data()[index].generation };
+    }
+
+    // erase everything; all outstanding handles become stale
+    void clear() {
+        for (size_t position = 0; position < m_Owners.size(); ++position) {
+            release_slot(m_Owners.data()[position]);
+        }
+        m_Values.clear();
+        m_Owners.clear();
+    }
+
+    void reserve(size_t count) {
+        m_Values.reserve(count);
+        m_Owners.reserve(count);
+        m_Slots.reserve(count);
+    }
+
+    // Index operator: element by dense position (checks bounds)
+    T& operator[](size_t position) { return m_Values[position]; }
+    const T& operator[](size_t position) const { return m_Values[position]; }
+
+    // accessors
+    size_t size() const { return m_Values.size(); }
+    bool empty() const { return m_Values.empty(); }
+    size_t slot_count() const { return m_Slots.size(); }
+    T* data() { return m_Values.data(); }
+    const T* data() const { return m_Values.data(); }
+
+    // contiguous iteration over the dense elements (order changes on erase)
+    typename SimpelVector<T>::Iterator begin() { return m_Values.begin(); }
+    typename SimpelVector<T>::Iterator end() { return m_Values.end(); }
+    typename SimpelVector<T>::ConstIterator begin() const { return m_Values.cbegin(); }
+    typename SimpelVector<T>::ConstIterator end() const { return m_Values.cend(); }
+};
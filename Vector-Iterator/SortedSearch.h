@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "Platform.h"
+
+// Position of 'key' among n sorted keys: the number of keys < key
+// (OrEqual = false, lower_bound) or <= key (OrEqual = true, upper_bound).
+// Meant for short ranges such as a B+-tree node or a learned index's window.
+// For 4- and 8-byte integer keys, branchless bisection (cmov) narrows the range
+// to a window of at most 16 keys, which are then compared at once with AVX2 and
+// the matches counted: no data-dependent branches, so none of a binary
+// search's mispredictions, and only the window's two cache lines are scanned.
+// Other key types use std::lower_bound / std::upper_bound.
+template <bool OrEqual, typename Key>
+size_t sorted_rank(const Key* keys, size_t n, const Key& key) {
+    size_t i = 0;
+    size_t count = 0;
+#if defined(SIMPEL_HAS_AVX2)
+    if constexpr (std::is_integral_v<Key> && (sizeof(Key) == 8 || sizeof(Key) == 4)) {
+        // keys before the window are known to rank below 'key', keys after it above
+        while (n > 16) {
+            const size_t half = n / 2;
+            const bool below = OrEqual ? !(key < keys[half - 1]) : keys[half - 1] < key;
+            count += below ? half : 0;
+            keys += below ? half : 0;
+            n -= half;
+        }
+        // signed compares only: flip the sign bit of unsigned keys to keep their order
+        constexpr bool flip = std::is_unsigned_v<Key>;
+        if constexpr (sizeof(Key) == 8) {
+            const __m256i bias = _mm256_set1_epi64x(flip ? static_cast<long long>(uint64_t(1) << 63) : 0);
+            const __m256i needle = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(key)), bias);
+            for (; i + 4 <= n; i += 4) {
+                const __m256i block = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), bias);
+                __m256i hit = _mm256_cmpgt_epi64(needle, block);
+                if constexpr (OrEqual) {
+                    hit = _mm256_or_si256(hit, _mm256_cmpeq_epi64(needle, block));
+                }
+                count += static_cast<size_t>(std::popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(hit)))));
+            }
+        } else {
+            const __m256i bias = _mm256_set1_epi32(flip ? static_cast<int>(uint32_t(1) << 31) : 0);
+            const __m256i needle = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(key)), bias);
+            for (; i + 8 <= n; i += 8) {
+                const __m256i block = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), bias);
+                __m256i hit = _mm256_cmpgt_epi32(needle, block);
+                if constexpr (OrEqual) {
+                    hit = _mm256_or_si256(hit, _mm256_cmpeq_epi32(needle, block));
+                }
+                count += static_cast<size_t>(std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(hit)))));
+            }
+        }
+        for (; i < n; ++i) {
+            count += OrEqual ? !(key < keys[i]) : keys[i] < key;
+        }
+        return count;
+    }
+#endif
+    (void)i;
+    (void)count;
+    if constexpr (OrEqual) {
+        return static_cast<size_t>(std::upper_bound(keys, keys + n, key) - keys);
+    } else {
+        return static_cast<size_t>(std::lower_bound(keys, keys + n, key) - keys);
+    }
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include "SimpelVector.h"
+#include "Platform.h"
+
+// Sparse vector: only the non-zero entries are stored, as sorted 32-bit
+// indices plus values in two parallel SimpelVectors. Indices must be added in
+// increasing order (push_back throws otherwise), which keeps every operation a
+// linear merge.
+//
+// The sparse-sparse dot product intersects the index lists four at a time with
+// SSE2: a block of 4 indices from each side is compared all-against-all with
+// 4 rotated compares, and the block with the smaller last index is advanced.
+template <typename T>
+class SparseVector {
+private:
+    size_t m_Dimension;             // logical length of the vector
+    SimpelVector<uint32_t> m_Indices;
+    SimpelVector<T> m_Values;
+
+    // throw unless 'other' has the same dimension
+    void check_dimension(size_t other) const {
+        if (other != m_Dimension) {
+            throw std::invalid_argument("Vector dimensions do not match");
+        }
+    }
+
+public:
+    explicit SparseVector(size_t dimension = 0) : m_Dimension(dimension) {
+        if (dimension > size_t(std::numeric_limits<uint32_t>::max()) + 1) {
+            throw std::length_error("SparseVector dimension exceeds 32-bit indices");
+        }
+    }
+
+    // keep the entries of 'dense' that differ from 'zero'
+    static SparseVector from_dense(const SimpelVector<T>& dense, const T& zero = T()) {
+        SparseVector result(dense.size());
+        const T* data = dense.data();
+        for (size_t i = 0; i < dense.size(); ++i) {
+            if (data[i] != zero) {
+                result.m_Indices.push_back(static_cast<uint32_t>(i));
+                result.m_Values.push_back(data[i]);
+            }
+        }
+        return result;
+    }
+
+    SimpelVector<T> to_dense(const T& zero = T()) const {
+        SimpelVector<T> dense;
+        dense.resize(m_Dimension, zero);
+        T* data = dense.data();
+        for (size_t k = 0; k < nnz(); ++k) {
+            data[m_Indices.data()[k]] = m_Values.data()[k];
+        }
+        return dense;
+    }
+
+    // append a non-zero entry; index must be larger than every stored index
+    void push_back(size_t index, const T& value) {
+        if (index >= m_Dimension) {
+            throw std::out_of_range("Index out of range");
+        }
+        if (!m_Indices.empty() && index <= m_Indices.data()[m_Indices.size() - 1]) {
+            throw std::invalid_argument("Sparse indices must be strictly increasing");
+        }
+        m_Indices.push_back(static_cast<uint32_t>(index));
+        m_Values.push_back(value);
+    }
+
+    // value at 'index' (binary search; T() when the entry is not stored)
+    T operator[](size_t index) const {
+        if (index >= m_Dimension) {
+            throw std::out_of_range("Index out of range");
+        }
+        const uint32_t* first = m_Indices.data();
+        const uint32_t* last = first + m_Indices.size();
+        const uint32_t* it = std::lower_bound(first, last, static_cast<uint32_t>(index));
+        return it != last && *it == index ? m_Values.data()[it - first] : T();
+    }
+
+    // sparse-dense dot product
+    T dot(const SimpelVector<T>& dense) const {
+        check_dimension(dense.size());
+        const uint32_t* idx = m_Indices.data();
+        const T* values = m_Values.data();
+        const T* data = dense.data();
+        T sum = T();
+        for (size_t k = 0; k < nnz(); ++k) {
+            if (k + kPrefetchDistance < nnz()) {
+                SIMPEL_PREFETCH(data + idx[k + kPrefetchDistance]);
+            }
+            sum += values[k] * data[idx[k]];
+        }
+        return sum;
+    }
+
+    // sparse-sparse dot product over the intersection of the index lists
+    T dot(const SparseVector& other) const {
+        check_dimension(other.m_Dimension);
+        const uint32_t* a = m_Indices.data();
+        const uint32_t* b = other.m_Indices.data();
+        const T* va = m_Values.data();
+        const T* vb = other.m_Values.data();
+        const size_t na = nnz();
+        const size_t nb = other.nnz();
+        size_t i = 0;
+        size_t j = 0;
+        T sum = T();
+
+#if defined(SIMPEL_HAS_SSE2)
+        while (i + 4 <= na && j + 4 <= nb) {
+            const __m128i block_a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            const __m128i block_b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+            __m128i match = _mm_cmpeq_epi32(block_a, block_b);
+            match = _mm_or_si128(match, _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(0, 3, 2, 1))));
+            match = _mm_or_si128(match, _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(1, 0, 3, 2))));
+            match = _mm_or_si128(match, _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(2, 1, 0, 3))));
+
+            unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(match)));
+            while (mask) {
+                // a[i + k] occurs in b's block: find where (at most 4 compares, rarely taken)
+                const size_t k = static_cast<size_t>(std::countr_zero(mask));
+                mask &= mask - 1;
+                size_t m = 0;
+                while (b[j + m] != a[i + k]) {
+                    ++m;
+                }
+                sum += va[i + k] * vb[j + m];
+            }
+
+            const uint32_t last_a = a[i + 3];
+            const uint32_t last_b = b[j + 3];
+            i += last_a <= last_b ? 4 : 0;
+            j += last_b <= last_a ? 4 : 0;
+        }
+#endif
+        // scalar merge for the tails (and for builds without SSE2)
+        while (i < na && j < nb) {
+            if (a[i] < b[j]) {
+                ++i;
+            } else if (b[j] < a[i]) {
+                ++j;
+            } else {
+                sum += va[i++] * vb[j++];
+            }
+        }
+        return sum;
+    }
+
+    // element-wise sum (union of the index lists)
+    SparseVector add(const SparseVector& other) const {
+        check_dimension(other.m_Dimension);
+        SparseVector result(m_Dimension);
+        result.m_Indices.reserve(nnz() + other.nnz());
+        result.m_Values.reserve(nnz() + other.nnz());
+        size_t i = 0;
+        size_t j = 0;
+        while (i < nnz() || j < other.nnz()) {
+            const bool take_a = j == other.nnz() || (i < nnz() && m_Indices.data()[i] <= other.m_Indices.data()[j]);
+            const bool take_b = i == nnz() || (j < other.nnz() && other.m_Indices.data()[j] <= m_Indices.data()[i]);
+            if (take_a && take_b) {
+                result.m_Indices.push_back(m_Indices.data()[i]);
+                result.m_Values.push_back(m_Values.data()[i++] + other.m_Values.data()[j++]);
+            } else if (take_a) {
+                result.m_Indices.push_back(m_Indices.data()[i]);
+                result.m_Values.push_back(m_Values.data()[i++]);
+            } else {
+                result.m_Indices.push_back(other.m_Indices.data()[j]);
+                result.m_Values.push_back(other.m_Values.data()[j++]);
+            }
+        }
+        return result;
+    }
+
+    // multiply every stored value by 'factor' in place
+    void scale(const T& factor) {
+        T* values = m_Values.data();
+        for (size_t k = 0; k < nnz(); ++k) {
+            values[k] *= factor;
+        }
+    }
+
+    // accessors
+    size_t dimension() const { return m_Dimension; }
+    size_t nnz() const { return m_Indices.size(); } // number of stored entries
+    const SimpelVector<uint32_t>& indices() const { return m_Indices; }
+    const SimpelVector<T>& values() const { return m_Values; }
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+#include "SimpelVector.h"
+
+// Fixed-capacity sibling of SimpelVector that keeps its elements inline.
+// It never touches the heap: push_back throws std::length_error when full and
+// try_push_back reports failure instead. There are no user-declared copy/move
+// operations, so StaticVector<T, N> is trivially copyable whenever T is.
+// Iterators are SimpelVector's, so code written against SimpelVector iterators
+// (and std algorithms) works unchanged.
+//
+// Like SimpelVector (new T[]), all N slots are default-constructed up front.
+template <typename T, size_t N>
+class StaticVector {
+private:
+    T m_Data[N == 0 ? 1 : N]; // inline storage
+    size_t m_Size = 0;        // number of elements currently stored
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using Iterator = typename SimpelVector<T>::Iterator;
+    using ConstIterator = typename SimpelVector<T>::ConstIterator;
+
+    constexpr StaticVector() : m_Data() {}
+
+    // Initializer-list constructor: throws std::length_error if init has more than N elements
+    constexpr StaticVector(std::initializer_list<T> init) : StaticVector() {
+        for (const auto& val : init) {
+            push_back(val);
+        }
+    }
+
+    // Index operator (non-const): checks bounds and returns reference
+    constexpr T& operator[](size_t index) {
+        if (index >= m_Size) {
+            throw std::out_of_range("Index out of range");
+        }
+        return m_Data[index];
+    }
+
+    // Index operator (const)
+    constexpr const T& operator[](size_t index) const {
+        if (index >= m_Size) {
+            throw std::out_of_range("Index out of range");
+        }
+        return m_Data[index];
+    }
+
+    // try_push_back: append if there is room, return false (and leave value untouched) if full
+    constexpr bool try_push_back(const T& value) {
+        if (m_Size == N) {
+            return false;
+        }
+        m_Data[m_Size++] = value;
+        return true;
+    }
+
+    constexpr bool try_push_back(T&& value) {
+        if (m_Size == N) {
+            return false;
+        }
+        m_Data[m_Size++] = std::move(value);
+        return true;
+    }
+
+    // push_back: like SimpelVector's, but a full vector throws instead of growing
+    constexpr void push_back(const T& value) {
+        if (!try_push_back(value)) {
+            throw std::length_error("StaticVector is full");
+        }
+    }
+
+    constexpr void push_back(T&& value) {
+        if (!try_push_back(std::move(value))) {
+            throw std::length_error("StaticVector is full");
+        }
+    }
+
+    // pop_back: remove last element (doesn't call destructor explicitly)
+    constexpr void pop_back() {
+        if (m_Size == 0) {
+            throw std::out_of_range("Vector is empty");
+        }
+        --m_Size;
+    }
+
+    // insert: shift [position, size) up by one slot and store 'value' at 'position'
+    constexpr void insert(size_t position, const T& value) {
+        if (position > m_Size) {
+            throw std::out_of_range("Index out of range");
+        }
+        if (m_Size == N) {
+            throw std::length_error("StaticVector is full");
+        }
+        for (size_t i = m_Size; i > position; --i) {
+            m_Data[i] = std::move(m_Data[i - 1]);
+        }
+        m_Data[position] = value;
+        ++m_Size;
+    }
+
+    // erase: remove the element at 'position', shifting the rest down by one slot
+    constexpr void erase(size_t position) {
+        if (position >= m_Size) {
+            throw std::out_of_range("Index out of range");
+        }
+        for (size_t i = position; i + 1 < m_Size; ++i) {
+            m_Data[i] = std::move(m_Data[i + 1]);
+        }
+        --m_Size;
+    }
+
+    // resize: shrink, or grow with copies of 'value'; throws std::length_error beyond N
+    constexpr void resize(size_t new_size, const T& value = T()) {
+        if (new_size > N) {
+            throw std::length_error("StaticVector is full");
+        }
+        for (size_t i = m_Size; i < new_size; ++i) {
+            m_Data[i] = value;
+        }
+        m_Size = new_size;
+    }
+
+    // reverse: in place, since there is no second buffer to move into
+    constexpr void reverse() {
+        for (size_t i = 0; i < m_Size / 2; ++i) {
+            std::swap(m_Data[i], m_Data[m_Size - 1 - i]);
+        }
+    }
+
+    // clear: logically remove all elements by setting size to 0
+    constexpr void clear() { m_Size = 0; }
+
+    // accessors
+    constexpr size_t size() const { return m_Size; }
+    static constexpr size_t capacity() { return N; }
+    constexpr bool empty() const { return m_Size == 0; }
+    constexpr bool full() const { return m_Size == N; }
+
+    constexpr T* data() { return m_Data; }
+    constexpr const T* data() const { return m_Data; }
+
+    // iterator access
+    constexpr Iterator begin() { return Iterator(m_Data); }
+    constexpr Iterator end() { return Iterator(m_Data + m_Size); }
+
+    constexpr ConstIterator begin() const { return ConstIterator(m_Data); }
+    constexpr ConstIterator end() const { return ConstIterator(m_Data + m_Size); }
+
+    constexpr ConstIterator cbegin() const { return ConstIterator(m_Data); }
+    constexpr ConstIterator cend() const { return ConstIterator(m_Data + m_Size); }
+};
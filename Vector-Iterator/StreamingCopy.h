@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "Platform.h"
+
+// Non-temporal ("streaming") copy and fill for blocks far larger than the
+// cache. Ordinary stores first read every destination line into the cache
+// (read-for-ownership) and leave both source and destination there, evicting
+// the working set of every other thread sharing the cache; a multi-GB copy
+// flushes the whole last-level cache. Streaming stores write full cache lines
+// straight to memory instead. The destination is aligned to a cache line
+// with a short ordinary copy, the body is streamed line by line, the ragged
+// tail is copied normally, and an sfence ends the call so the data is visible
+// to other threads before it returns.
+//
+// SimpelVector routes its copies, relocations and fills of trivially copyable
+// elements through here once a block reaches streaming_threshold() bytes.
+
+constexpr size_t kCacheLine = 64;
+
+// how far ahead stream_copy prefetches the source, non-temporally
+constexpr size_t kStreamPrefetchBytes = 8 * kCacheLine;
+
+// default: beyond this, a copy would wipe out a large share of a typical L3 anyway
+constexpr size_t kDefaultStreamingThreshold = size_t(8) << 20;
+
+inline std::atomic<size_t>& streaming_threshold_setting() {
+    static std::atomic<size_t> threshold(kDefaultStreamingThreshold);
+    return threshold;
+}
+
+// Block size in bytes from which copies and fills use streaming stores
+inline size_t streaming_threshold() { return streaming_threshold_setting().load(std::memory_order_relaxed); }
+
+// Change the threshold process-wide; SIZE_MAX turns streaming off, 0 streams everything
+inline void set_streaming_threshold(size_t bytes) { streaming_threshold_setting().store(bytes, std::memory_order_relaxed); }
+
+// Write one full cache line at the line-aligned 'dst' from 'src' (any
+// alignment) without reading the destination line. Needs a store fence before
+// the data is handed to another thread (SIMPEL_STORE_FENCE).
+inline void stream_line(void* dst, const void* src) {
+#if defined(SIMPEL_HAS_AVX2)
+    const __m256i* in = static_cast<const __m256i*>(src);
+    __m256i* out = static_cast<__m256i*>(dst);
+    const __m256i low = _mm256_loadu_si256(in);
+    const __m256i high = _mm256_loadu_si256(in + 1);
+    _mm256_stream_si256(out, low);
+    _mm256_stream_si256(out + 1, high);
+#elif defined(SIMPEL_HAS_SSE2)
+    const __m128i* in = static_cast<const __m128i*>(src);
+    __m128i* out = static_cast<__m128i*>(dst);
+    for (int i = 0; i < 4; ++i) {
+        _mm_stream_si128(out + i, _mm_loadu_si128(in + i));
+    }
+#else
+    std::memcpy(dst, src, kCacheLine);
+#endif
+}
+
+// memcpy with streaming stores for the cache-line-aligned body of 'dst'
+inline void stream_copy(void* dst, const void* src, size_t bytes) {
+    char* out = static_cast<char*>(dst);
+    const char* in = static_cast<const char*>(src);
+    const size_t head = (kCacheLine - reinterpret_cast<uintptr_t>(out) % kCacheLine) % kCacheLine;
+    if (bytes < head + kCacheLine) {
+        std::memcpy(out, in, bytes);
+        return;
+    }
+    std::memcpy(out, in, head);
+    const size_t body = (bytes - head) / kCacheLine * kCacheLine;
+    for (size_t offset = head; offset < head + body; offset += kCacheLine) {
+        if (offset + kStreamPrefetchBytes < bytes) {
+            SIMPEL_PREFETCH_NTA(in + offset + kStreamPrefetchBytes);
+        }
+        stream_line(out + offset, in + offset);
+    }
+    std::memcpy(out + head + body, in + head + body, bytes - head - body);
+    SIMPEL_STORE_FENCE();
+}
+
+// dst[0 .. count) = value, with streaming stores for whole cache lines.
+// T must be trivially copyable; types that do not tile a cache line (or a
+// misaligned dst) are filled with ordinary stores.
+template <typename T>
+void stream_fill(T* dst, size_t count, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "stream_fill needs trivially copyable elements");
+    size_t i = 0;
+    if constexpr (sizeof(T) <= kCacheLine && kCacheLine % sizeof(T) == 0) {
+        constexpr size_t per_line = kCacheLine / sizeof(T);
+        if (reinterpret_cast<uintptr_t>(dst) % sizeof(T) == 0) {
+            alignas(kCacheLine) T pattern[per_line];
+            for (size_t slot = 0; slot < per_line; ++slot) {
+                pattern[slot] = value;
+            }
+            for (; i < count && reinterpret_cast<uintptr_t>(dst + i) % kCacheLine != 0; ++i) {
+                dst[i] = value;
+            }
+            for (; i + per_line <= count; i += per_line) {
+                ::stream_line(dst + i, pattern);
+            }
+            SIMPEL_STORE_FENCE();
+        }
+    }
+    for (; i < count; ++i) {
+        dst[i] = value;
+    }
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "SimpelVector.h"
+#include "Parallel.h"
+#include "Platform.h"
+
+// Data reshuffling kernels: gather, scatter, permute and matrix transpose.
+// Large inputs are split over the thread pool; within a chunk the scalar loops
+// prefetch the random side kPrefetchDistance elements ahead, and gathers of
+// 4- or 8-byte elements with 64-bit indices use AVX2 / AVX-512 gather
+// instructions when the build enables them.
+// Indices are validated (std::out_of_range for negative or too large ones)
+// before anything is written to a vector the caller passed in.
+
+namespace kernel_detail {
+
+// throw if any index in [begin, end) is negative or >= limit
+template <typename Index>
+void check_indices(const Index* indices, size_t begin, size_t end, size_t limit) {
+    if (begin >= end) {
+        return;
+    }
+    Index min_index = indices[begin];
+    Index max_index = indices[begin];
+    for (size_t i = begin + 1; i < end; ++i) {
+        // branch-free: vectorizes (min_index is dead code for unsigned indices)
+        min_index = indices[i] < min_index ? indices[i] : min_index;
+        max_index = indices[i] > max_index ? indices[i] : max_index;
+    }
+    if constexpr (std::is_signed_v<Index>) {
+        if (min_index < 0) {
+            throw std::out_of_range("Index out of range");
+        }
+    }
+    if (static_cast<size_t>(max_index) >= limit) {
+        throw std::out_of_range("Index out of range");
+    }
+}
+
+// out[i] = src[indices[i]] for i in [begin, end)
+template <typename T, typename Index>
+void gather_range(const T* src, const Index* indices, T* out, size_t begin, size_t end) {
+    size_t i = begin;
+#if defined(SIMPEL_HAS_AVX512) || defined(SIMPEL_HAS_AVX2)
+    constexpr bool kSimd = std::is_trivially_copyable_v<T> && sizeof(Index) == 8 && (sizeof(T) == 4 || sizeof(T) == 8);
+    if constexpr (kSimd) {
+#if defined(SIMPEL_HAS_AVX512)
+        for (; i + 8 <= end; i += 8) {
+            const __m512i idx = _mm512_loadu_si512(indices + i);
+            if constexpr (sizeof(T) == 8) {
+                _mm512_storeu_si512(out + i, _mm512_i64gather_epi64(idx, src, 8));
+            } else {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_i64gather_epi32(idx, src, 4));
+            }
+        }
+#else
+        for (; i + 4 <= end; i += 4) {
+            const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i));
+            if constexpr (sizeof(T) == 8) {
+                const __m256i values = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(src), idx, 8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), values);
+            } else {
+                const __m128i values = _mm256_i64gather_epi32(reinterpret_cast<const int*>(src), idx, 4);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), values);
+            }
+        }
+#endif
+    }
+#endif
+    for (; i < end; ++i) {
+        if (i + kPrefetchDistance < end) {
+            SIMPEL_PREFETCH(src + indices[i + kPrefetchDistance]);
+        }
+        out[i] = src[indices[i]];
+    }
+}
+
+} // namespace kernel_detail
+
+// gather: result[i] = src[indices[i]]
+template <typename T, typename Index>
+SimpelVector<T> gather(const SimpelVector<T>& src, const SimpelVector<Index>& indices) {
+    static_assert(std::is_integral_v<Index>, "indices must be integers");
+    SimpelVector<T> result;
+    result.resize(indices.size());
+    const T* in = src.data();
+    const Index* idx = indices.data();
+    T* out = result.data();
+    const size_t limit = src.size();
+
+    parallel_for(indices.size(), [&](size_t begin, size_t end) {
+        kernel_detail::check_indices(idx, begin, end, limit);
+        kernel_detail::gather_range(in, idx, out, begin, end);
+    });
+    return result;
+}
+
+// scatter: dst[indices[i]] = values[i]
+// With duplicate indices the surviving value is unspecified once the
+// scatter runs in parallel; pass distinct indices (e.g. a permutation).
+template <typename T, typename Index>
+void scatter(const SimpelVector<T>& values, const SimpelVector<Index>& indices, SimpelVector<T>& dst) {
+    static_assert(std::is_integral_v<Index>, "indices must be integers");
+    if (values.size() != indices.size()) {
+        throw std::invalid_argument("scatter needs one index per value");
+    }
+    const T* in = values.data();
+    const Index* idx = indices.data();
+    T* out = dst.data();
+    const size_t limit = dst.size();
+
+    // validate everything first so a bad index leaves dst untouched
+    parallel_for(indices.size(), [&](size_t begin, size_t end) {
+        kernel_detail::check_indices(idx, begin, end, limit);
+    });
+    parallel_for(indices.size(), [&](size_t begin, size_t end) {
+        size_t i = begin;
+#if defined(SIMPEL_HAS_AVX512)
+        if constexpr (std::is_trivially_copyable_v<T> && sizeof(Index) == 8 && (sizeof(T) == 4 || sizeof(T) == 8)) {
+            for (; i + 8 <= end; i += 8) {
+                const __m512i vindex = _mm512_loadu_si512(idx + i);
+                if constexpr (sizeof(T) == 8) {
+                    _mm512_i64scatter_epi64(out, vindex, _mm512_loadu_si512(in + i), 8);
+                } else {
+                    _mm512_i64scatter_epi32(out, vindex, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)), 4);
+                }
+            }
+        }
+#endif
+        for (; i < end; ++i) {
+            if (i + kPrefetchDistance < end) {
+                SIMPEL_PREFETCH(out + idx[i + kPrefetchDistance]);
+            }
+            out[idx[i]] = in[i];
+        }
+    });
+}
+
+// permute: vec becomes [vec[perm[0]], vec[perm[1]], ...]
+// perm must have one entry per element; the old buffer is released afterwards.
+template <typename T, typename Index>
+void permute(SimpelVector<T>& vec, const SimpelVector<Index>& perm) {
+    if (perm.size() != vec.size()) {
+        throw std::invalid_argument("Permutation size does not match vector size");
+    }
+    SimpelVector<T> permuted = gather(vec, perm);
+    vec.swap(permuted);
+}
+
+// Transpose a row-major rows x cols matrix stored flat in 'src'.
+// The matrix is cut into block x block tiles; each tile is read row by row and
+// written column by column, so both sides stay in cache. Bands of output rows
+// are handed to the thread pool.
+template <typename T>
+SimpelVector<T> transpose(const SimpelVector<T>& src, size_t rows, size_t cols, size_t block = 32) {
+    if (rows * cols != src.size()) {
+        throw std::invalid_argument("Matrix shape does not match vector size");
+    }
+    if (block == 0) {
+        throw std::invalid_argument("Block size must not be zero");
+    }
+    SimpelVector<T> result;
+    result.resize(src.size());
+    const T* in = src.data();
+    T* out = result.data();
+
+    // each task owns a band of source columns = a band of output rows
+    const size_t bands = (cols + block - 1) / block;
+    parallel_for(bands, [&](size_t band_begin, size_t band_end) {
+        for (size_t band = band_begin; band < band_end; ++band) {
+            const size_t j0 = band * block;
+            const size_t j1 = j0 + block < cols ? j0 + block : cols;
+            for (size_t i0 = 0; i0 < rows; i0 += block) {
+                const size_t i1 = i0 + block < rows ? i0 + block : rows;
+                for (size_t i = i0; i < i1; ++i) {
+                    if (i + block < rows) {
+                        SIMPEL_PREFETCH(in + (i + block) * cols + j0); // same tile one block further down
+                    }
+                    for (size_t j = j0; j < j1; ++j) {
+                        out[j * rows + i] = in[i * cols + j];
+                    }
+                }
+            }
+        }
+    }, rows == 0 ? 1 : kParallelGrain / (rows * block) + 1);
+    return result;
+}
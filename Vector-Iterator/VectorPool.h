@@ -0,0 +1,246 @@
+#pragma once
+
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "SimpelVector.h"
+
+// Recycling pool for SimpelVector buffers.
+// Released vectors are cleared and kept together with their capacity, bucketed
+// by capacity class (class c holds capacities in [2^c, 2^(c+1))). acquire()
+// hands one back instead of letting a new vector walk the doubling ladder from
+// resize_capacity(1) again.
+//
+// The pool is lock-striped: it keeps hardware_concurrency() shards, each
+// behind its own mutex, and every thread uses the shard its thread id hashes
+// to. Concurrent threads therefore mostly lock different shards, but a shard
+// is not a thread_local cache: two threads can share one. (Real thread_local
+// caches would have to outlive pools that are destroyed while threads still
+// run.) When a shard bucket is full, the vector goes to the global overflow.
+//
+// Buckets that have not been used for 'idle_time' are trimmed automatically,
+// at most once per 'idle_time': from acquire() and release(), and from a
+// background thread that wakes up every 'idle_time', so a pool that is not
+// touched at all still gives its memory back (within about 2 * idle_time).
+// trim() does the same explicitly; an idle_time of zero disables the thread.
+//
+// Vectors move in and out of the pool by SimpelVector::swap, so neither
+// elements nor vector objects are copied.
+template <typename T>
+class VectorPool {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    static constexpr size_t kClassCount = sizeof(size_t) * 8;
+    static constexpr size_t kClassSearch = 2; // look at most this many classes above the ideal one
+
+    struct Bucket {
+        std::vector<SimpelVector<T>> vectors; // reserved up front: never reallocates
+        Clock::time_point last_use;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        Bucket buckets[kClassCount];
+    };
+
+    size_t m_ShardLimit;  // vectors per class in each shard
+    size_t m_GlobalLimit; // vectors per class in the global overflow
+    Clock::duration m_IdleTime;
+    size_t m_ShardCount;
+    std::unique_ptr<Shard[]> m_Shards;
+    Shard m_Global;
+    std::mutex m_TrimMutex;
+    Clock::time_point m_LastTrim;
+    std::mutex m_TimerMutex;
+    std::condition_variable m_TimerCv;
+    bool m_Stopping;
+    std::thread m_Trimmer; // last: started once everything else is constructed
+
+    // class that a vector with this capacity is stored under
+    static size_t class_of(size_t capacity) { return std::bit_width(capacity) - 1; }
+
+    // smallest class whose vectors all have at least min_capacity
+    static size_t class_for(size_t min_capacity) {
+        return min_capacity <= 1 ? 0 : std::bit_width(min_capacity - 1);
+    }
+
+    Shard& thread_shard() {
+        return m_Shards[std::hash<std::thread::id>()(std::this_thread::get_id()) % m_ShardCount];
+    }
+
+    // take a vector with at least min_capacity out of a shard (false if none fits)
+    bool take(Shard& shard, size_t min_capacity, SimpelVector<T>& out) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const size_t first = class_for(min_capacity);
+        for (size_t c = first; c < kClassCount && c <= first + kClassSearch; ++c) {
+            Bucket& bucket = shard.buckets[c];
+            if (!bucket.vectors.empty()) {
+                out.swap(bucket.vectors.back());
+                bucket.vectors.pop_back();
+                bucket.last_use = Clock::now();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // put 'vec' into a shard bucket if there is room (false if the bucket is full)
+    bool put(Shard& shard, size_t limit, SimpelVector<T>& vec) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Bucket& bucket = shard.buckets[class_of(vec.capacity())];
+        if (bucket.vectors.size() >= limit) {
+            return false;
+        }
+        if (bucket.vectors.capacity() < limit) {
+            bucket.vectors.reserve(limit);
+        }
+        bucket.vectors.emplace_back();
+        bucket.vectors.back().swap(vec);
+        bucket.last_use = Clock::now();
+        return true;
+    }
+
+    static void trim_shard(Shard& shard, Clock::time_point cutoff) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (Bucket& bucket : shard.buckets) {
+            if (!bucket.vectors.empty() && bucket.last_use < cutoff) {
+                bucket.vectors.clear(); // frees the pooled buffers
+            }
+        }
+    }
+
+public:
+    explicit VectorPool(size_t shard_limit = 8, size_t global_limit = 64,
+                        Clock::duration idle_time = std::chrono::seconds(10))
+        : m_ShardLimit(shard_limit), m_GlobalLimit(global_limit), m_IdleTime(idle_time),
+          m_ShardCount(std::thread::hardware_concurrency() == 0 ? 1 : std::thread::hardware_concurrency()),
+          m_Shards(new Shard[m_ShardCount]), m_LastTrim(Clock::now()), m_Stopping(false) {
+        if (m_IdleTime > Clock::duration::zero()) {
+            m_Trimmer = std::thread([this]() { trim_periodically(); });
+        }
+    }
+
+    ~VectorPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_TimerMutex);
+            m_Stopping = true;
+        }
+        m_TimerCv.notify_all();
+        if (m_Trimmer.joinable()) {
+            m_Trimmer.join();
+        }
+    }
+
+    VectorPool(const VectorPool&) = delete;
+    VectorPool& operator=(const VectorPool&) = delete;
+
+    // Swap a cleared vector with capacity >= min_capacity into 'out'.
+    // Falls back to a fresh vector reserved to the next power of two.
+    void acquire(SimpelVector<T>& out, size_t min_capacity) {
+        SimpelVector<T> vec;
+        if (min_capacity > 0 && !take(thread_shard(), min_capacity, vec) && !take(m_Global, min_capacity, vec)) {
+            vec.reserve(std::bit_ceil(min_capacity));
+        }
+        out.swap(vec); // whatever 'out' held is released with 'vec'
+        maybe_trim();
+    }
+
+    // Give a vector back to the pool. 'vec' is left empty.
+    // Vectors without capacity, or that find every bucket full, are simply freed.
+    void release(SimpelVector<T>& vec) {
+        SimpelVector<T> taken;
+        taken.swap(vec);
+        if (taken.capacity() > 0) {
+            taken.clear();
+            if (!put(thread_shard(), m_ShardLimit, taken)) {
+                put(m_Global, m_GlobalLimit, taken);
+            }
+        }
+        maybe_trim();
+    }
+
+    // Free every pooled vector whose bucket was not used within idle_time.
+    void trim() {
+        const Clock::time_point cutoff = Clock::now() - m_IdleTime;
+        for (size_t i = 0; i < m_ShardCount; ++i) {
+            trim_shard(m_Shards[i], cutoff);
+        }
+        trim_shard(m_Global, cutoff);
+    }
+
+    // Free all pooled vectors.
+    void purge() {
+        const Clock::time_point cutoff = Clock::time_point::max();
+        for (size_t i = 0; i < m_ShardCount; ++i) {
+            trim_shard(m_Shards[i], cutoff);
+        }
+        trim_shard(m_Global, cutoff);
+    }
+
+    // number of vectors currently held by the pool
+    size_t pooled() {
+        size_t count = 0;
+        auto count_shard = [&count](Shard& shard) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (const Bucket& bucket : shard.buckets) {
+                count += bucket.vectors.size();
+            }
+        };
+        for (size_t i = 0; i < m_ShardCount; ++i) {
+            count_shard(m_Shards[i]);
+        }
+        count_shard(m_Global);
+        return count;
+    }
+
+    // RAII lease: acquires on construction and releases back to the pool on destruction
+    class Lease {
+    private:
+        VectorPool* m_Pool;
+        SimpelVector<T> m_Vector;
+    public:
+        Lease(VectorPool& pool, size_t min_capacity) : m_Pool(&pool) { pool.acquire(m_Vector, min_capacity); }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() { m_Pool->release(m_Vector); }
+
+        SimpelVector<T>& operator*() { return m_Vector; }
+        SimpelVector<T>* operator->() { return &m_Vector; }
+    };
+
+    Lease lease(size_t min_capacity) { return Lease(*this, min_capacity); }
+
+private:
+    void maybe_trim() {
+        std::unique_lock<std::mutex> lock(m_TrimMutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return; // another thread is trimming
+        }
+        const Clock::time_point now = Clock::now();
+        if (now - m_LastTrim < m_IdleTime) {
+            return;
+        }
+        m_LastTrim = now;
+        lock.unlock();
+        trim();
+    }
+
+    // background thread: trims every idle_time until the pool is destroyed
+    void trim_periodically() {
+        std::unique_lock<std::mutex> lock(m_TimerMutex);
+        while (!m_TimerCv.wait_for(lock, m_IdleTime, [this]() { return m_Stopping; })) {
+            lock.unlock();
+            maybe_trim();
+            lock.lock();
+        }
+    }
+};
@@ -1,232 +1,556 @@
 #include <iostream>
-#include <cstddef>
-#include <initializer_list>
-#include <utility>
-#include <stdexcept>
-
-// Simple dynamic array class template (similar to a tiny std::vector)
-template <typename T>
-class SimpelVector {
-private:
-    T* m_Data;         // pointer to the allocated array
-    size_t m_Size;     // number of elements currently stored
-    size_t m_Capacity; // allocated capacity (number of T objects that fit without realloc)
-
-    // Resize the internal buffer to at least new_capacity.
-    // If new_capacity < m_Size, we bump it up to m_Size so we don't lose elements.
-    // This implementation allocates a new dynamic array, moves existing elements into it,
-    // deletes the old array and updates the pointer and capacity.
-    void resize_capacity(size_t new_capacity) {
-        if (new_capacity < m_Size) {
-            new_capacity = m_Size;
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+#include <string>
+
+#include "SimpelVector.h"
+#include "AsyncLoader.h"
+#include "BatchStream.h"
+#include "VectorPool.h"
+#include "SlabAllocator.h"
+#include "NumaPlacement.h"
+#include "ConstexprTable.h"
+#include "StaticVector.h"
+#include "NdVector.h"
+#include "VectorKernels.h"
+#include "BlobVector.h"
+#include "JaggedVector.h"
+#include "SparseVector.h"
+#include "GapBuffer.h"
+#include "LiveBitmap.h"
+#include "RoaringBitmap.h"
+#include "IndexedVector.h"
+#include "SlotMap.h"
+#include "DaryHeap.h"
+#include "BPlusTree.h"
+#include "EytzingerVector.h"
+#include "LearnedIndex.h"
+#include "PrefixSum.h"
+#include "Aggregate.h"
+#include "RadixPartition.h"
+#include "Benchmark.h"
+
+// write a small binary file and load it back with the overlapped loader
+void demo_async_loader() {
+    const char* path = "async_loader_demo.bin";
+    {
+        std::ofstream file(path, std::ios::binary);
+        for (size_t i = 1; i <= 1000; ++i) {
+            file.write(reinterpret_cast<const char*>(&i), sizeof(i));
         }
+    }
 
-        T* new_data = new T[new_capacity];
-        for (size_t i = 0; i < m_Size; ++i) {
-            // Move elements into the new storage (note: requires T to be move-assignable)
-            new_data[i] = std::move(m_Data[i]);
-        }
-        delete[] m_Data;       // free old storage
-        m_Data = new_data;
-        m_Capacity = new_capacity;
-    }
-
-public:
-    // Forward iterator (non-const)
-    class Iterator {
-    private:
-        T* m_Ptr;
-    public:
-        Iterator(T* ptr) : m_Ptr(ptr) {}
-        T& operator*() const { return *m_Ptr; }             // dereference
-        Iterator& operator++() { ++m_Ptr; return *this; }   // pre-increment
-        Iterator operator++(int) { Iterator tmp = *this; ++m_Ptr; return tmp; } // post-increment
-        Iterator& operator--() { --m_Ptr; return *this; }   // pre-decrement
-        Iterator operator--(int) { Iterator tmp = *this; --m_Ptr; return tmp; } // post-decrement
-        bool operator==(const Iterator& other) const { return m_Ptr == other.m_Ptr; }
-        bool operator!=(const Iterator& other) const { return m_Ptr != other.m_Ptr; }
-    };
-
-    // Const iterator
-    class ConstIterator {
-    private:
-        const T* m_Ptr;
-    public:
-        ConstIterator(const T* ptr) : m_Ptr(ptr) {}
-        const T& operator*() const { return *m_Ptr; }
-        ConstIterator& operator++() { ++m_Ptr; return *this; }
-        ConstIterator operator++(int) { ConstIterator tmp = *this; ++m_Ptr; return tmp; }
-        ConstIterator& operator--() { --m_Ptr; return *this; }
-        ConstIterator operator--(int) { ConstIterator tmp = *this; --m_Ptr; return tmp; }
-        bool operator==(const ConstIterator& other) const { return m_Ptr == other.m_Ptr; }
-        bool operator!=(const ConstIterator& other) const { return m_Ptr != other.m_Ptr; }
-    };
+    SimpelVector<size_t> loaded;
+    load_binary_async(path, loaded, 256); // small blocks so the demo goes round the buffer ring
+    std::remove(path);
 
-    // Default constructor: start empty
-    SimpelVector() : m_Data(nullptr), m_Size(0), m_Capacity(0) {}
+    size_t sum = 0;
+    for (const auto& val : loaded) {
+        sum += val;
+    }
+    std::cout << "Async load (" << async_load_backend() << "): " << loaded.size() << " values, sum = " << sum << std::endl;
+}
+
+// a coroutine stage streams batches through a bounded channel to a consumer thread
+void demo_batch_stream() {
+    SimpelVector<size_t> source;
+    for (size_t i = 1; i <= 100; ++i) {
+        source.push_back(i);
+    }
 
-    // Initializer-list constructor: push each element
-    SimpelVector(std::initializer_list<T> init) : SimpelVector() {
-        for (const auto& val : init) {
-            push_back(val);
+    BatchChannel<size_t> channel(2, 16); // two 16-element buffers in circulation
+    auto stream = batches(source, 16);
+    std::thread producer([&]() { stream_to_channel(stream, channel); });
+
+    SimpelVector<size_t> batch;
+    size_t batch_count = 0;
+    size_t sum = 0;
+    while (channel.receive(batch)) {
+        ++batch_count;
+        for (const auto& val : batch) {
+            sum += val;
+        }
+        channel.release(batch);
+    }
+    producer.join();
+    std::cout << "Batch stream: " << batch_count << " batches, sum = " << sum << std::endl;
+}
+
+// repeated batches reuse pooled buffers instead of growing new vectors each time
+void demo_vector_pool() {
+    VectorPool<size_t> pool;
+    const size_t* first_buffer = nullptr;
+    bool reused = true;
+    for (size_t round = 0; round < 3; ++round) {
+        auto batch = pool.lease(100);
+        for (size_t i = 0; i < 100; ++i) {
+            batch->push_back(i);
+        }
+        if (round == 0) {
+            first_buffer = batch->data();
+        } else {
+            reused = reused && batch->data() == first_buffer;
+        }
+    }
+    std::cout << "Vector pool: buffer reused = " << (reused ? "yes" : "no")
+              << ", pooled vectors = " << pool.pooled() << std::endl;
+}
+
+// grow a buffer by doubling and count how often the slab allocator expanded it in place
+void demo_slab_allocator() {
+    SlabAllocator& slab = SlabAllocator::instance();
+    size_t bytes = 64;
+    void* data = slab.allocate(bytes);
+    size_t in_place = 0;
+    size_t moved = 0;
+    while (bytes < 4096) {
+        if (slab.try_expand(data, bytes, bytes * 2)) {
+            ++in_place;
+        } else {
+            void* grown = slab.allocate(bytes * 2);
+            std::memcpy(grown, data, bytes);
+            slab.deallocate(data, bytes);
+            data = grown;
+            ++moved;
         }
+        bytes *= 2;
+    }
+    slab.deallocate(data, bytes);
+    std::cout << "Slab allocator: " << in_place << " in-place expansions, " << moved << " moves" << std::endl;
+
+    // the same through SlabVector: push_back growth that keeps its buffer address was expanded in place
+    SlabVector<int> values;
+    size_t buffers = 0;
+    const int* last = nullptr;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+        if (values.data() != last) {
+            last = values.data();
+            ++buffers;
+        }
+    }
+    std::cout << "Slab vector: " << values.size() << " elements, " << buffers << " buffers for "
+              << std::bit_width(values.capacity()) << " growth steps" << std::endl;
+}
+
+// interleave a large buffer over the NUMA nodes and sum it with node-local chunks
+void demo_numa_placement() {
+    SimpelVector<size_t> values;
+    values.reserve(size_t(1) << 20);
+    numa_place(values, NumaPolicy::Interleave); // before the first touch: pages follow the policy
+    for (size_t i = 0; i < (size_t(1) << 20); ++i) {
+        values.push_back(i % 7);
     }
 
-    // Copy constructor: deep copy of the other SimpelVector
-    SimpelVector(const SimpelVector& other) : m_Data(nullptr), m_Size(other.m_Size), m_Capacity(other.m_Capacity) {
-        std::cout << "Copy constructor called" << std::endl;
-        if (other.m_Data) {
-            m_Data = new T[m_Capacity];
-            for (size_t i = 0; i < m_Size; ++i) {
-                // Copy-assign each element
-                m_Data[i] = other.m_Data[i];
-            }
+    std::atomic<size_t> sum{0};
+    numa_parallel_for(values, [&](size_t begin, size_t end) {
+        size_t local = 0;
+        for (size_t i = begin; i < end; ++i) {
+            local += values[i];
         }
+        sum += local;
+    });
+    std::cout << "NUMA placement: " << numa_node_count() << " node(s), sum = " << sum << std::endl;
+}
+
+// lookup table computed entirely at compile time: the quadratic residues modulo 97
+constexpr SimpelVector<int> make_quadratic_residues() {
+    SimpelVector<int> squares;
+    for (int i = 1; i < 97; ++i) {
+        squares.push_back(i * i % 97);
     }
+    std::sort(squares.begin(), squares.end());
 
-    // Move constructor: take ownership of other's buffer and leave it empty
-    SimpelVector(SimpelVector&& other) noexcept : m_Data(other.m_Data), m_Size(other.m_Size), m_Capacity(other.m_Capacity) {
-        std::cout << "Move constructor called" << std::endl;
-        other.m_Data = nullptr;
-        other.m_Size = 0;
-        other.m_Capacity = 0;
+    // every residue appears twice (i and 97 - i), keep one of each
+    SimpelVector<int> residues;
+    for (const auto& val : squares) {
+        if (residues.empty() || residues[residues.size() - 1] != val) {
+            residues.push_back(val);
+        }
     }
+    return residues;
+}
 
-    // Copy assignment operator
-    SimpelVector& operator=(const SimpelVector& other) {
-        std::cout << "Copy assignment operator called" << std::endl;
-        if (this != &other) {
-            // allocate new buffer (or nullptr if other has no data)
-            T* new_data = other.m_Data ? new T[other.m_Capacity] : nullptr;
+constexpr auto kQuadraticResidues = to_static_array<make_quadratic_residues>();
+static_assert(kQuadraticResidues.size() == 48, "half of the non-zero values mod 97 are squares");
 
-            if (new_data) {
-                for (size_t i = 0; i < other.m_Size; ++i) {
-                    new_data[i] = other.m_Data[i]; // copy elements
-                }
-            }
+void demo_constexpr_table() {
+    std::cout << "Constexpr table: " << kQuadraticResidues.size() << " residues, first ones: ";
+    for (size_t i = 0; i < 5; ++i) {
+        std::cout << kQuadraticResidues[i] << " ";
+    }
+    std::cout << std::endl;
+}
 
-            delete[] m_Data; // free existing storage
+// inline vector for code that must not allocate: fills up, then refuses politely
+static_assert(std::is_trivially_copyable_v<StaticVector<int, 8>>, "trivial T gives a trivially copyable StaticVector");
 
-            // replace members with the new buffer
-            m_Data = new_data;
-            m_Size = other.m_Size;
-            m_Capacity = other.m_Capacity;
-        }
-        return *this;
-    }
-
-    // Move assignment operator: free current buffer, steal other's buffer
-    SimpelVector& operator=(SimpelVector&& other) noexcept {
-        std::cout << "Move assignment operator called" << std::endl;
-        if (this != &other) {
-            delete[] m_Data;                // free current storage
-            m_Data = other.m_Data;          // steal pointer
-            m_Size = other.m_Size;
-            m_Capacity = other.m_Capacity;
-            other.m_Data = nullptr;         // leave other in valid empty state
-            other.m_Size = 0;
-            other.m_Capacity = 0;
+void demo_static_vector() {
+    StaticVector<int, 4> values = { 3, 1, 2 };
+    values.push_back(0);
+    const bool accepted = values.try_push_back(5); // full: no allocation, just false
+    values.reverse();
+
+    std::cout << "Static vector: ";
+    for (const auto& val : values) {
+        std::cout << val << " ";
+    }
+    std::cout << "(5th push accepted = " << (accepted ? "yes" : "no") << ")" << std::endl;
+}
+
+// a 3x4 grid addressed by (row, column) instead of hand-computed flat indices
+void demo_nd_vector() {
+    NdVector<double, 2> grid({ 3, 4 });
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            grid(i, j) = static_cast<double>(i * 10 + j);
         }
-        return *this;
     }
+    NdVector<double, 2> flipped = grid.transposed();
+    std::cout << "NdVector: row stride = " << grid.stride(0) << " (padded), transposed(3, 2) = " << flipped(3, 2) << std::endl;
+}
 
-    // Destructor: free allocated storage
-    ~SimpelVector() { delete[] m_Data; }
+// reorder by an index vector, scatter back, and transpose a flat 2x3 matrix
+void demo_vector_kernels() {
+    SimpelVector<size_t> values = { 10, 20, 30, 40, 50 };
+    SimpelVector<size_t> order = { 4, 2, 0, 3, 1 };
+    SimpelVector<size_t> picked = gather(values, order);
 
-    // Index operator (non-const): checks bounds and returns reference
-    T& operator[](size_t index) {
-        if (index >= m_Size) {
-            throw std::out_of_range("Index out of range");
-        }
-        return m_Data[index];
-    }
+    SimpelVector<size_t> restored;
+    restored.resize(values.size());
+    scatter(picked, order, restored);
 
-    // Index operator (const)
-    const T& operator[](size_t index) const {
-        if (index >= m_Size) {
-            throw std::out_of_range("Index out of range");
-        }
-        return m_Data[index];
-    }
+    SimpelVector<size_t> matrix = { 1, 2, 3, 4, 5, 6 };
+    SimpelVector<size_t> flipped = transpose(matrix, 2, 3);
 
-    // push_back for lvalue references (copy)
-    void push_back(const T& value) {
-        if (m_Size == m_Capacity) {
-            // grow: if capacity is 0 set to 1, otherwise double
-            resize_capacity(m_Capacity == 0 ? 1 : m_Capacity * 2);
-        }
-        m_Data[m_Size++] = value; // copy-assign into next slot
+    std::cout << "Vector kernels: gathered ";
+    for (const auto& val : picked) {
+        std::cout << val << " ";
+    }
+    std::cout << "| restored[1] = " << restored[1] << " | transposed ";
+    for (const auto& val : flipped) {
+        std::cout << val << " ";
+    }
+    std::cout << std::endl;
+}
+
+// tokenizer-style output: many short strings in one buffer, sorted by permutation
+void demo_blob_vector() {
+    const char* tokens[] = { "vector", "iterator", "alloc", "value", "vec", "index" };
+    BlobVector words;
+    words.append(std::begin(tokens), std::end(tokens));
+    words.sort();
+
+    std::cout << "Blob vector (" << words.bytes() << " bytes): ";
+    for (const auto& word : words) {
+        std::cout << word << " ";
     }
+    std::cout << std::endl;
+}
+
+// adjacency lists of a small graph in one CSR buffer instead of one vector per node
+void demo_jagged_vector() {
+    SimpelVector<size_t> from = { 0, 0, 1, 2, 2, 2 };
+    SimpelVector<size_t> to = { 1, 2, 2, 0, 1, 3 };
+    JaggedVector<size_t> adjacency = JaggedVector<size_t>::build(4, from, to);
+    adjacency.push_back(3, 0); // node 3 gains an edge in place of rebuilding
+
+    std::cout << "Jagged vector: " << adjacency.size() << " edges, neighbours of 2: ";
+    for (const auto& node : adjacency[2]) {
+        std::cout << node << " ";
+    }
+    std::cout << std::endl;
+}
+
+// mostly-zero feature vectors scored without touching the zeros
+void demo_sparse_vector() {
+    SimpelVector<double> dense_features;
+    dense_features.resize(1000, 0.0);
+    dense_features[3] = 1.5;
+    dense_features[500] = 2.0;
+    dense_features[999] = -1.0;
+    SparseVector<double> features = SparseVector<double>::from_dense(dense_features);
+
+    SparseVector<double> weights(1000);
+    weights.push_back(3, 2.0);
+    weights.push_back(42, 7.0);
+    weights.push_back(500, 0.5);
+
+    std::cout << "Sparse vector: nnz = " << features.nnz() << ", sparse dot = " << features.dot(weights)
+              << ", dense dot = " << weights.dot(dense_features) << ", nnz of sum = " << features.add(weights).nnz() << std::endl;
+}
+
+// edit a line of text in the middle without shifting the rest of it
+void demo_gap_buffer() {
+    const char text[] = "Hello world";
+    GapBuffer<char> buffer;
+    buffer.insert(text, sizeof(text) - 1);
+    buffer.move_cursor(5);
+    buffer.insert(',');
+    buffer.move_cursor(buffer.size());
+    buffer.insert('!');
+
+    std::cout << "Gap buffer: ";
+    for (const auto& c : buffer.before()) {
+        std::cout << c;
+    }
+    for (const auto& c : buffer.after()) {
+        std::cout << c;
+    }
+    std::cout << std::endl;
+}
 
-    // push_back for rvalue references (move)
-    void push_back(T&& value) {
-        if (m_Size == m_Capacity) {
-            resize_capacity(m_Capacity == 0 ? 1 : m_Capacity * 2);
-        }
-        m_Data[m_Size++] = std::move(value); // move-assign
+// tombstone most records, skip over the dead ones, then compact
+void demo_live_bitmap() {
+    SimpelVector<int> records;
+    for (int i = 0; i < 10000; ++i) {
+        records.push_back(i);
     }
+    LiveBitmap live(records.size());
 
-    // pop_back: remove last element (doesn't call destructor explicitly)
-    void pop_back() {
-        if (m_Size == 0) {
-            throw std::out_of_range("Vector is empty");
+    SimpelVector<size_t> dead;
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (i % 1000 != 7) {
+            dead.push_back(i);
         }
-        --m_Size; // just reduce size; element's destructor is not called here
     }
+    live.reset_batch(dead);
+
+    std::cout << "Live bitmap: live records";
+    live.for_each_live([&](size_t i) { std::cout << " " << records[i]; });
+    compact(records, live);
+    std::cout << ", " << records.size() << " left after compact" << std::endl;
+}
+
+// posting lists as compressed bitmaps: intersect, unite, subtract and round-trip
+void demo_roaring_bitmap() {
+    SimpelVector<uint32_t> even;
+    SimpelVector<uint32_t> block;
+    for (uint32_t i = 0; i < 200000; i += 2) {
+        even.push_back(i);
+    }
+    for (uint32_t i = 100000; i < 300000; ++i) {
+        block.push_back(i);
+    }
+    RoaringBitmap a = RoaringBitmap::from_sorted(even);
+    RoaringBitmap b = RoaringBitmap::from_sorted(block);
+    b.run_optimize(); // one long run per chunk
+
+    const SimpelVector<char> bytes = b.serialize();
+    const RoaringBitmap restored = RoaringBitmap::deserialize(bytes.data(), bytes.size());
+
+    std::cout << "Roaring bitmap: |a & b| = " << (a & b).cardinality() << ", |a | b| = " << (a | b).cardinality()
+              << ", |a - b| = " << (a - b).cardinality() << ", b serialized in " << bytes.size() << " bytes ("
+              << block.size() * sizeof(uint32_t) << " as a vector), restored " << restored.cardinality() << std::endl;
+}
+
+// records in one vector, looked up by id without a separate map
+void demo_indexed_vector() {
+    struct Account {
+        size_t id;
+        double balance;
+    };
+    struct AccountId {
+        size_t operator()(const Account& account) const { return account.id; }
+    };
 
-    // reserve: ensure capacity is at least new_capacity
-    void reserve(size_t new_capacity) {
-        if (new_capacity <= m_Capacity) {
-            return;
-        }
-        resize_capacity(new_capacity);
+    IndexedVector<Account, AccountId> accounts;
+    for (size_t id = 100; id < 110; ++id) {
+        accounts.insert(Account{ id, id * 1.5 });
     }
+    accounts.erase(103); // the last account (109) takes its place
+    accounts.find(105)->balance = 0.0;
 
-    // reverse: create a new buffer with elements in reverse order
-    // keeps the current capacity (allocates m_Capacity size)
-    void reverse() {
-        if (m_Size <= 1) {
-            return;
-        }
+    std::cout << "Indexed vector: ids";
+    for (const auto& account : accounts) {
+        std::cout << " " << account.id;
+    }
+    std::cout << ", balance of 105 = " << accounts.at(105).balance << ", contains 103: " << accounts.contains(103) << std::endl;
+}
+
+// handles stay valid across growth and erase; stale ones are detected
+void demo_slot_map() {
+    struct Position {
+        float x;
+        float y;
+    };
+    SlotMap<Position> positions;
+    const SlotHandle player = positions.insert(Position{ 1.0f, 2.0f });
+    const SlotHandle enemy = positions.insert(Position{ 5.0f, 5.0f });
+    for (int i = 0; i < 1000; ++i) {
+        positions.insert(Position{ 0.0f, 0.0f }); // reallocates the dense storage
+    }
+    positions.erase(enemy);
+    const SlotHandle pickup = positions.insert(Position{ 3.0f, 4.0f }); // reuses the enemy's slot
+
+    std::cout << "Slot map: player at (" << positions.at(player).x << ", " << positions.at(player).y << "), enemy handle "
+              << (positions.contains(enemy) ? "live" : "stale") << ", pickup in slot " << pickup.index
+              << " generation " << pickup.generation << std::endl;
+}
+
+// timers: bulk-load a 4-ary min-heap, re-arm one timer, drain the earliest ones
+void demo_dary_heap() {
+    const uint64_t deadlines[] = { 40, 10, 70, 20, 90, 30, 60, 50, 80 };
+    DaryHeap<uint64_t, 4, std::greater<uint64_t>> timers;
+    timers.push_bulk(deadlines, sizeof(deadlines) / sizeof(deadlines[0]));
+    SimpelVector<uint64_t> due;
+    timers.pop_n(3, due);
+
+    IndexedDaryHeap<uint64_t> by_task(4);
+    by_task.push(0, 40);
+    by_task.push(1, 25);
+    by_task.push(2, 90);
+    by_task.decrease_key(2, 5); // task 2 is now due first
+
+    RadixHeap<const char*> events;
+    events.push(30, "write");
+    events.push(10, "read");
+    events.push(20, "flush");
+
+    std::cout << "d-ary heap: first due";
+    for (const auto& deadline : due) {
+        std::cout << " " << deadline;
+    }
+    std::cout << ", next task " << by_task.top_id() << " at " << by_task.top_key() << ", first event " << events.pop().second << std::endl;
+}
+
+// ordered index: bulk-load sorted keys, insert more, scan a key range
+void demo_bplus_tree() {
+    SimpelVector<uint64_t> keys;
+    SimpelVector<double> prices;
+    for (uint64_t key = 0; key < 1000; key += 10) {
+        keys.push_back(key);
+        prices.push_back(key * 0.5);
+    }
+    BPlusTree<uint64_t, double> index = BPlusTree<uint64_t, double>::bulk_load(keys, prices);
+    index.insert(425, 1.0);
+    index.insert(431, 2.0);
 
-        T* reversed_data = new T[m_Capacity];
-        for (size_t i = 0; i < m_Size; ++i) {
-            // move elements from the end into the new buffer in forward order
-            reversed_data[i] = std::move(m_Data[m_Size - 1 - i]);
-        }
+    std::cout << "B+-tree: " << index.size() << " keys in " << index.height() << " levels, range [420, 450):";
+    index.for_each_in_range(420, 450, [](uint64_t key, double price) { std::cout << " " << key << "=" << price; });
+    std::cout << std::endl;
+}
 
-        delete[] m_Data;
-        m_Data = reversed_data;
+// id -> row lookups through the Eytzinger layout; results are ranks in the sorted ids
+void demo_eytzinger_vector() {
+    SimpelVector<size_t> ids;
+    for (size_t id = 1000; id < 2000; id += 7) {
+        ids.push_back(id);
     }
-
-    // shrink_to_fit: reduce capacity to match size (reallocates)
-    void shrink_to_fit() {
-        if (m_Size < m_Capacity) {
-            resize_capacity(m_Size);
-        }
+    const EytzingerVector<size_t> index(ids);
+
+    std::cout << "Eytzinger vector: row of id 1070 = " << index.find(1070) << ", lower_bound(1500) = row "
+              << index.lower_bound(1500) << " (id " << ids[index.lower_bound(1500)] << "), contains 1071: "
+              << index.contains(1071) << std::endl;
+}
+
+// timestamp -> row lookups: a few linear segments stand in for a search tree
+void demo_learned_index() {
+    SimpelVector<uint64_t> timestamps;
+    for (uint64_t i = 0; i < 10000; ++i) {
+        timestamps.push_back(1700000000 + i * 60 + (i * 37) % 11); // one sample a minute, with jitter
+    }
+    const LearnedIndex<uint64_t> index(timestamps, 8);
+
+    std::cout << "Learned index: " << index.segments() << " segment(s) for " << index.size() << " timestamps ("
+              << index.bytes() << " bytes), row of 1700030009 = " << index.find(1700030009)
+              << ", first row at or after 1700060000 = " << index.lower_bound(1700060000) << std::endl;
+}
+
+// rate limiting: requests per second in a Fenwick tree, sliding-window totals as range sums
+void demo_prefix_sums() {
+    SimpelVector<uint64_t> per_second = { 3, 0, 5, 2, 8, 1, 4, 6 };
+    SimpelVector<uint64_t> running = inclusive_scan(per_second);
+    SimpelVector<uint64_t> offsets = exclusive_scan(per_second);
+
+    FenwickTree<uint64_t> window(per_second);
+    window.add(3, 4); // four late requests in second 3
+    struct Max {
+        uint64_t operator()(uint64_t a, uint64_t b) const { return a > b ? a : b; }
+    };
+    SegmentTree<uint64_t, Max> peaks(per_second);
+
+    std::cout << "Prefix sums: total " << running[running.size() - 1] << ", second 4 starts at request "
+              << offsets[4] << ", requests in seconds [2, 6) = " << window.range_sum(2, 6)
+              << ", busiest of seconds [0, 4) = " << peaks.query(0, 4)
+              << ", 20th request falls in second " << window.lower_bound(20) - 1 << std::endl;
+}
+
+// order analytics: orders per hour of day, revenue per hour, revenue per customer
+void demo_aggregation() {
+    SimpelVector<uint8_t> hours = { 9, 9, 10, 13, 13, 13, 17, 9 };
+    SimpelVector<uint64_t> customers = { 4711, 42, 4711, 7, 42, 4711, 7, 7 };
+    SimpelVector<double> amounts = { 12.5, 3.0, 7.5, 20.0, 1.0, 4.0, 9.5, 2.5 };
+
+    const SimpelVector<uint64_t> orders = histogram(hours, 24);
+    const SimpelVector<double> revenue = group_by_sum(hours, amounts, 24);
+    const GroupSums<uint64_t, double> per_customer = group_by_sum(customers, amounts);
+
+    std::cout << "Aggregation: orders at 9h = " << orders[9] << ", at 13h = " << orders[13]
+              << ", revenue at 13h = " << revenue[13] << ", per customer:";
+    for (size_t i = 0; i < per_customer.keys.size(); ++i) {
+        std::cout << " " << per_customer.keys[i] << "=" << per_customer.sums[i];
     }
+    std::cout << std::endl;
+}
 
-    // clear: logically remove all elements by setting size to 0
-    // NOTE: this does not explicitly call element destructors
-    void clear() { m_Size = 0; }
+// orders joined with their customers by customer id
+void demo_hash_join() {
+    SimpelVector<uint64_t> customer_ids = { 7, 42, 4711, 1000 };
+    SimpelVector<uint64_t> order_customers = { 4711, 42, 4711, 7, 99, 42 };
 
-    // accessors
-    size_t size() const { return m_Size; }
-    size_t capacity() const { return m_Capacity; }
-    bool empty() const { return m_Size == 0; }
+    const JoinPairs pairs = hash_join(customer_ids, order_customers);
+    std::cout << "Hash join: " << pairs.build_rows.size() << " matches (customer row, order row):";
+    for (size_t i = 0; i < pairs.build_rows.size(); ++i) {
+        std::cout << " (" << pairs.build_rows[i] << ", " << pairs.probe_rows[i] << ")";
+    }
+    std::cout << std::endl;
+}
 
-    // iterator access
-    Iterator begin() { return Iterator(m_Data); }
-    Iterator end() { return Iterator(m_Data + m_Size); }
+void demo_streaming_copy() {
+    const size_t saved_threshold = streaming_threshold();
+    set_streaming_threshold(0); // stream every copy and fill, not just the 8 MiB ones
 
-    ConstIterator begin() const { return ConstIterator(m_Data); }
-    ConstIterator end() const { return ConstIterator(m_Data + m_Size); }
+    // 1003 elements end part-way into a cache line, so every path has a ragged tail
+    SimpelVector<uint32_t> source;
+    for (uint32_t i = 0; i < 1003; ++i) {
+        source.push_back(i * 7);
+    }
+    SimpelVector<uint32_t> copy(source);        // copy constructor
+    copy.append(source.data(), source.size());  // append
+    copy.resize(copy.size() + 517, 0xABCDu);    // fill
+
+    bool intact = copy.size() == 2 * source.size() + 517;
+    for (size_t i = 0; intact && i < copy.size(); ++i) {
+        const uint32_t expected = i < 2 * source.size() ? source[i % source.size()] : 0xABCDu;
+        intact = copy[i] == expected;
+    }
 
-    ConstIterator cbegin() const { return ConstIterator(m_Data); }
-    ConstIterator cend() const { return ConstIterator(m_Data + m_Size); }
-};
+    // destination one byte past an aligned buffer: head, streamed body and tail all run
+    SimpelVector<char> bytes;
+    bytes.resize(source.size() * sizeof(uint32_t) + 1);
+    stream_copy(bytes.data() + 1, source.data(), source.size() * sizeof(uint32_t));
+    const bool unaligned_intact = std::memcmp(bytes.data() + 1, source.data(), source.size() * sizeof(uint32_t)) == 0;
+
+    set_streaming_threshold(saved_threshold);
+    std::cout << "Streaming copy: " << copy.size() << " elements copied, appended and filled, intact = "
+              << (intact ? "yes" : "no") << ", unaligned stream_copy intact = "
+              << (unaligned_intact ? "yes" : "no") << std::endl;
+}
+
+int main(int argc, char** argv) {
+    // "--bench" runs the benchmark suite instead of the demos
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        run_benchmarks();
+        return 0;
+    }
 
-int main() {
     // create a temporary SimpelVector from an initializer_list and move it into 'vec'
     SimpelVector<size_t> vec = std::move(SimpelVector<size_t>({ 1, 2, 3, 4, 5 }));
     SimpelVector<size_t> vec2;
@@ -255,5 +579,31 @@ int main() {
     }
     std::cout << std::endl;
 
+    demo_async_loader();
+    demo_batch_stream();
+    demo_vector_pool();
+    demo_slab_allocator();
+    demo_numa_placement();
+    demo_constexpr_table();
+    demo_static_vector();
+    demo_nd_vector();
+    demo_vector_kernels();
+    demo_blob_vector();
+    demo_jagged_vector();
+    demo_sparse_vector();
+    demo_gap_buffer();
+    demo_live_bitmap();
+    demo_roaring_bitmap();
+    demo_indexed_vector();
+    demo_slot_map();
+    demo_dary_heap();
+    demo_bplus_tree();
+    demo_eytzinger_vector();
+    demo_learned_index();
+    demo_prefix_sums();
+    demo_aggregation();
+    demo_hash_join();
+    demo_streaming_copy();
+
     return 0;
 }
\ No newline at end of file